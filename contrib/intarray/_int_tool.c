@@ -10,6 +10,48 @@
 #include "common/int.h"
 #include "lib/qunique.h"
 
+/*
+ * When one sorted input is this many times longer than the other, it's
+ * cheaper to search the longer one for each element of the shorter one
+ * than to merge them.
+ */
+#define GALLOP_RATIO	16
+
+/*
+ * Return the index of the first element of sorted array d[lo..n) that is
+ * >= key, or n if there is none.  We gallop forward from lo before doing
+ * a binary search, so a series of calls with increasing keys costs only
+ * O(log distance) each.
+ */
+static int
+int_gallop(const int *d, int lo, int n, int key)
+{
+	int			hi = lo;
+	int			step = 1;
+
+	while (hi < n && d[hi] < key)
+	{
+		lo = hi + 1;
+		hi += step;
+		step *= 2;
+	}
+	if (hi > n)
+		hi = n;
+
+	/* the answer is now in [lo, hi] */
+	while (lo < hi)
+	{
+		int			mid = lo + (hi - lo) / 2;
+
+		if (d[mid] < key)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
 /* arguments are assumed sorted & unique-ified */
 bool
 inner_int_contains(ArrayType *a, ArrayType *b)
@@ -61,6 +103,32 @@ inner_int_overlap(ArrayType *a, ArrayType *b)
 	da = ARRPTR(a);
 	db = ARRPTR(b);
 
+	/* make a the shorter array */
+	if (na > nb)
+	{
+		int		   *dt = da;
+		int			nt = na;
+
+		da = db;
+		na = nb;
+		db = dt;
+		nb = nt;
+	}
+
+	if ((int64) na * GALLOP_RATIO < nb)
+	{
+		j = 0;
+		for (i = 0; i < na; i++)
+		{
+			j = int_gallop(db, j, nb, da[i]);
+			if (j >= nb)
+				break;
+			if (db[j] == da[i])
+				return true;
+		}
+		return false;
+	}
+
 	i = j = 0;
 	while (i < na && j < nb)
 	{
@@ -155,7 +223,31 @@ inner_int_inter(ArrayType *a, ArrayType *b)
 	r = new_intArrayType(Min(na, nb));
 	dr = ARRPTR(r);
 
+	/* make a the shorter array */
+	if (na > nb)
+	{
+		int		   *dt = da;
+		int			nt = na;
+
+		da = db;
+		na = nb;
+		db = dt;
+		nb = nt;
+	}
+
 	i = j = k = 0;
+	if ((int64) na * GALLOP_RATIO < nb)
+	{
+		for (; i < na; i++)
+		{
+			j = int_gallop(db, j, nb, da[i]);
+			if (j >= nb)
+				break;
+			if (db[j] == da[i] && (k == 0 || dr[k - 1] != db[j]))
+				dr[k++] = db[j];
+		}
+	}
+
 	while (i < na && j < nb)
 	{
 		if (da[i] < db[j])
@@ -34,6 +34,16 @@ SELECT '{1}'::int[] & '{2}'::int[];
 SELECT array_dims('{1}'::int[] & '{2}'::int[]);
 SELECT ('{1}'::int[] & '{2}'::int[]) = '{}'::int[];
 SELECT ('{}'::int[] & '{}'::int[]) = '{}'::int[];
+-- overlap and intersection with one array much longer than the other
+SELECT '{5,5,200}'::int[] & array(SELECT generate_series(1, 200));
+SELECT array(SELECT generate_series(1, 200)) & '{200,5,5}'::int[];
+SELECT '{0,200}'::int[] && array(SELECT generate_series(1, 200));
+SELECT '{0,201}'::int[] && array(SELECT generate_series(1, 200));
+SELECT array(SELECT generate_series(1, 200)) && '{-1,0}'::int[];
+SELECT '{201,300}'::int[] & array(SELECT generate_series(1, 200));
+SELECT array(SELECT g / 2 FROM generate_series(0, 401) g) & '{7,7,3,200,250}'::int[];
+SELECT '{250,200}'::int[] && array(SELECT g / 2 FROM generate_series(0, 401) g);
+SELECT '{250,201}'::int[] && array(SELECT g / 2 FROM generate_series(0, 401) g);
 
 
 --test query_int
@@ -240,3 +240,11 @@ SELECT DISTINCT city, similarity(city, 'Warsaw'), show_limit()
 SELECT set_limit(0.5);
 SELECT DISTINCT city, similarity(city, 'Warsaw'), show_limit()
   FROM restaurants WHERE city % 'Warsaw';
+
+-- The second argument's trigrams are cached across calls; make sure the
+-- cache notices when it changes.
+SELECT id, a, b, similarity(a, b) AS sml, a % b AS match, a <-> b AS dist
+  FROM (VALUES (1, 'word', 'word'), (2, 'word', 'ward'), (3, 'word', 'xyz'),
+               (4, 'abc', 'abcd'), (5, 'word', 'word'), (6, 'word', 'ward'))
+       AS v(id, a, b)
+  ORDER BY id;
@@ -55,6 +55,14 @@ typedef struct
 	int			index;
 } pos_trgm;
 
+/* Cached trigrams of similarity()'s second argument, see similarity_query_trgm */
+typedef struct
+{
+	int			querylen;		/* length of querydata, in bytes */
+	char	   *querydata;		/* argument's data bytes (no header) */
+	TRGM	   *trigrams;		/* trigrams extracted from it */
+} similarity_cache;
+
 /* Trigram bound type */
 typedef uint8 TrgmBound;
 #define TRGM_BOUND_LEFT				0x01	/* trigram is left bound of word */
@@ -1165,26 +1173,96 @@ trgm_presence_map(TRGM *query, TRGM *key)
 	return result;
 }
 
-Datum
-similarity(PG_FUNCTION_ARGS)
+/*
+ * Return the trigrams of the second argument of similarity() and the
+ * operators built on it, caching them in fn_extra.
+ *
+ * In the common case of "column % 'constant'" the second argument is the
+ * same on every call, so we keep its trigrams rather than extracting them
+ * again for each row.  The cache is a single chunk in fn_mcxt holding the
+ * header, the argument's data bytes and then the TRGM value, the latter two
+ * starting at MAXALIGN boundaries.  Without an flinfo (e.g., when called
+ * through DirectFunctionCall) we just extract into a fresh TRGM.
+ */
+static TRGM *
+similarity_query_trgm(FunctionCallInfo fcinfo, text *query, bool *cached)
+{
+	similarity_cache *cache;
+	char	   *querydata = VARDATA_ANY(query);
+	int			querylen = VARSIZE_ANY_EXHDR(query);
+	TRGM	   *qtrg;
+
+	if (fcinfo->flinfo == NULL)
+	{
+		*cached = false;
+		return generate_trgm(querydata, querylen);
+	}
+
+	cache = (similarity_cache *) fcinfo->flinfo->fn_extra;
+	if (cache == NULL ||
+		cache->querylen != querylen ||
+		memcmp(cache->querydata, querydata, querylen) != 0)
+	{
+		similarity_cache *newcache;
+
+		qtrg = generate_trgm(querydata, querylen);
+
+		newcache = (similarity_cache *)
+			MemoryContextAlloc(fcinfo->flinfo->fn_mcxt,
+							   MAXALIGN(sizeof(similarity_cache)) +
+							   MAXALIGN(querylen) +
+							   VARSIZE(qtrg));
+
+		newcache->querylen = querylen;
+		newcache->querydata =
+			(char *) newcache + MAXALIGN(sizeof(similarity_cache));
+		memcpy(newcache->querydata, querydata, querylen);
+		newcache->trigrams = (TRGM *)
+			(newcache->querydata + MAXALIGN(querylen));
+		memcpy(newcache->trigrams, qtrg, VARSIZE(qtrg));
+		pfree(qtrg);
+
+		if (cache)
+			pfree(cache);
+		fcinfo->flinfo->fn_extra = newcache;
+		cache = newcache;
+	}
+
+	*cached = true;
+	return cache->trigrams;
+}
+
+/*
+ * Workhorse for similarity(), similarity_dist() and similarity_op().
+ */
+static float4
+calc_similarity(FunctionCallInfo fcinfo)
 {
 	text	   *in1 = PG_GETARG_TEXT_PP(0);
 	text	   *in2 = PG_GETARG_TEXT_PP(1);
 	TRGM	   *trg1,
 			   *trg2;
+	bool		trg2_cached;
 	float4		res;
 
 	trg1 = generate_trgm(VARDATA_ANY(in1), VARSIZE_ANY_EXHDR(in1));
-	trg2 = generate_trgm(VARDATA_ANY(in2), VARSIZE_ANY_EXHDR(in2));
+	trg2 = similarity_query_trgm(fcinfo, in2, &trg2_cached);
 
 	res = cnt_sml(trg1, trg2, false);
 
 	pfree(trg1);
-	pfree(trg2);
+	if (!trg2_cached)
+		pfree(trg2);
 	PG_FREE_IF_COPY(in1, 0);
 	PG_FREE_IF_COPY(in2, 1);
 
-	PG_RETURN_FLOAT4(res);
+	return res;
+}
+
+Datum
+similarity(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_FLOAT4(calc_similarity(fcinfo));
 }
 
 Datum
@@ -1222,9 +1300,7 @@ strict_word_similarity(PG_FUNCTION_ARGS)
 Datum
 similarity_dist(PG_FUNCTION_ARGS)
 {
-	float4		res = DatumGetFloat4(DirectFunctionCall2(similarity,
-														 PG_GETARG_DATUM(0),
-														 PG_GETARG_DATUM(1)));
+	float4		res = calc_similarity(fcinfo);
 
 	PG_RETURN_FLOAT4(1.0 - res);
 }
@@ -1232,9 +1308,7 @@ similarity_dist(PG_FUNCTION_ARGS)
 Datum
 similarity_op(PG_FUNCTION_ARGS)
 {
-	float4		res = DatumGetFloat4(DirectFunctionCall2(similarity,
-														 PG_GETARG_DATUM(0),
-														 PG_GETARG_DATUM(1)));
+	float4		res = calc_similarity(fcinfo);
 
 	PG_RETURN_BOOL(res >= similarity_threshold);
 }
@@ -129,6 +129,15 @@ static relopt_bool boolRelOpts[] =
 		},
 		true
 	},
+	{
+		{
+			"autocleanup",
+			"Enables pending list cleanup by autovacuum for this GIN index",
+			RELOPT_KIND_GIN,
+			AccessExclusiveLock
+		},
+		false
+	},
 	{
 		{
 			"security_barrier",
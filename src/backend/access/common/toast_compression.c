@@ -16,6 +16,9 @@
 #ifdef USE_LZ4
 #include <lz4.h>
 #endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
 
 #include "access/detoast.h"
 #include "access/toast_compression.h"
@@ -31,6 +34,12 @@ int			default_toast_compression = TOAST_PGLZ_COMPRESSION;
 			 errmsg("compression method lz4 not supported"), \
 			 errdetail("This functionality requires the server to be built with lz4 support.")))
 
+#define NO_ZSTD_SUPPORT() \
+	ereport(ERROR, \
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED), \
+			 errmsg("compression method zstd not supported"), \
+			 errdetail("This functionality requires the server to be built with zstd support.")))
+
 /*
  * Compress a varlena using PGLZ.
  *
@@ -245,6 +254,190 @@ lz4_decompress_datum_slice(const struct varlena *value, int32 slicelength)
 #endif
 }
 
+#ifdef USE_ZSTD
+/*
+ * zstd compression and decompression contexts, created on first use and kept
+ * for the life of the backend, so that we don't set up zstd's internal state
+ * afresh for every datum.
+ */
+static ZSTD_CCtx *zstd_cctx = NULL;
+static ZSTD_DCtx *zstd_dctx = NULL;
+
+static ZSTD_CCtx *
+zstd_get_cctx(void)
+{
+	if (zstd_cctx == NULL)
+	{
+		zstd_cctx = ZSTD_createCCtx();
+		if (zstd_cctx == NULL)
+			ereport(ERROR,
+					(errcode(ERRCODE_OUT_OF_MEMORY),
+					 errmsg("out of memory")));
+	}
+	return zstd_cctx;
+}
+
+static ZSTD_DCtx *
+zstd_get_dctx(void)
+{
+	if (zstd_dctx == NULL)
+	{
+		zstd_dctx = ZSTD_createDCtx();
+		if (zstd_dctx == NULL)
+			ereport(ERROR,
+					(errcode(ERRCODE_OUT_OF_MEMORY),
+					 errmsg("out of memory")));
+	}
+	return zstd_dctx;
+}
+#endif
+
+/*
+ * Compress a varlena using zstd.
+ *
+ * Returns the compressed varlena, or NULL if compression fails.
+ */
+struct varlena *
+zstd_compress_datum(const struct varlena *value)
+{
+#ifndef USE_ZSTD
+	NO_ZSTD_SUPPORT();
+	return NULL;				/* keep compiler quiet */
+#else
+	int32		valsize;
+	size_t		len;
+	size_t		max_size;
+	struct varlena *tmp = NULL;
+
+	valsize = VARSIZE_ANY_EXHDR(value);
+
+	/*
+	 * Figure out the maximum possible size of the zstd output, add the bytes
+	 * that will be needed for varlena overhead, and allocate that amount.
+	 */
+	max_size = ZSTD_compressBound(valsize);
+	tmp = (struct varlena *) palloc(max_size + VARHDRSZ_COMPRESSED);
+
+	len = ZSTD_compressCCtx(zstd_get_cctx(),
+							(char *) tmp + VARHDRSZ_COMPRESSED, max_size,
+							VARDATA_ANY(value), valsize,
+							ZSTD_CLEVEL_DEFAULT);
+	if (ZSTD_isError(len))
+		elog(ERROR, "zstd compression failed: %s", ZSTD_getErrorName(len));
+
+	/* data is incompressible so just free the memory and return NULL */
+	if (len > valsize)
+	{
+		pfree(tmp);
+		return NULL;
+	}
+
+	SET_VARSIZE_COMPRESSED(tmp, len + VARHDRSZ_COMPRESSED);
+
+	return tmp;
+#endif
+}
+
+/*
+ * Decompress a varlena that was compressed using zstd.
+ */
+struct varlena *
+zstd_decompress_datum(const struct varlena *value)
+{
+#ifndef USE_ZSTD
+	NO_ZSTD_SUPPORT();
+	return NULL;				/* keep compiler quiet */
+#else
+	size_t		rawsize;
+	struct varlena *result;
+
+	/* allocate memory for the uncompressed data */
+	result = (struct varlena *) palloc(VARDATA_COMPRESSED_GET_EXTSIZE(value) + VARHDRSZ);
+
+	/* decompress the data */
+	rawsize = ZSTD_decompressDCtx(zstd_get_dctx(),
+								  VARDATA(result),
+								  VARDATA_COMPRESSED_GET_EXTSIZE(value),
+								  (char *) value + VARHDRSZ_COMPRESSED,
+								  VARSIZE(value) - VARHDRSZ_COMPRESSED);
+	if (ZSTD_isError(rawsize))
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg_internal("compressed zstd data is corrupt")));
+
+	SET_VARSIZE(result, rawsize + VARHDRSZ);
+
+	return result;
+#endif
+}
+
+/*
+ * Decompress part of a varlena that was compressed using zstd.
+ *
+ * We use the streaming interface so that decompression stops as soon as
+ * the requested prefix has been produced.
+ */
+struct varlena *
+zstd_decompress_datum_slice(const struct varlena *value, int32 slicelength)
+{
+#ifndef USE_ZSTD
+	NO_ZSTD_SUPPORT();
+	return NULL;				/* keep compiler quiet */
+#else
+	struct varlena *result;
+	ZSTD_DCtx  *dctx;
+	ZSTD_inBuffer input;
+	ZSTD_outBuffer output;
+	bool		corrupt = false;
+
+	/* allocate memory for the uncompressed data */
+	result = (struct varlena *) palloc(slicelength + VARHDRSZ);
+
+	/* discard whatever state an earlier, abandoned stream left behind */
+	dctx = zstd_get_dctx();
+	ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only);
+
+	input.src = (char *) value + VARHDRSZ_COMPRESSED;
+	input.size = VARSIZE(value) - VARHDRSZ_COMPRESSED;
+	input.pos = 0;
+	output.dst = VARDATA(result);
+	output.size = slicelength;
+	output.pos = 0;
+
+	/* decompress until the output is full or the frame ends */
+	while (output.pos < output.size)
+	{
+		size_t		prev_in = input.pos;
+		size_t		prev_out = output.pos;
+		size_t		ret;
+
+		ret = ZSTD_decompressStream(dctx, &output, &input);
+		if (ZSTD_isError(ret))
+		{
+			corrupt = true;
+			break;
+		}
+		if (ret == 0)
+			break;
+		if (input.pos == prev_in && output.pos == prev_out)
+		{
+			/* no progress possible, so the input must be truncated */
+			corrupt = true;
+			break;
+		}
+	}
+
+	if (corrupt)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg_internal("compressed zstd data is corrupt")));
+
+	SET_VARSIZE(result, output.pos + VARHDRSZ);
+
+	return result;
+#endif
+}
+
 /*
  * Extract compression ID from a varlena.
  *
@@ -293,6 +486,13 @@ CompressionNameToMethod(const char *compression)
 #endif
 		return TOAST_LZ4_COMPRESSION;
 	}
+	else if (strcmp(compression, "zstd") == 0)
+	{
+#ifndef USE_ZSTD
+		NO_ZSTD_SUPPORT();
+#endif
+		return TOAST_ZSTD_COMPRESSION;
+	}
 
 	return InvalidCompressionMethod;
 }
@@ -309,6 +509,8 @@ GetCompressionMethodName(char method)
 			return "pglz";
 		case TOAST_LZ4_COMPRESSION:
 			return "lz4";
+		case TOAST_ZSTD_COMPRESSION:
+			return "zstd";
 		default:
 			elog(ERROR, "invalid compression method %c", method);
 			return NULL;		/* keep compiler quiet */
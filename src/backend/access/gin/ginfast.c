@@ -228,6 +228,7 @@ ginHeapTupleFastInsert(GinState *ginstate, GinTupleCollector *collector)
 	bool		separateList = false;
 	bool		needCleanup = false;
 	int			cleanupSize;
+	Size		pendingSize;
 	bool		needWal;
 
 	if (collector->ntuples == 0)
@@ -456,13 +457,29 @@ ginHeapTupleFastInsert(GinState *ginstate, GinTupleCollector *collector)
 	 * ginInsertCleanup() should not be called inside our CRIT_SECTION.
 	 */
 	cleanupSize = GinGetPendingListCleanupSize(index);
-	if (metadata->nPendingPages * GIN_PAGE_FREESIZE > cleanupSize * (Size) 1024)
+	pendingSize = metadata->nPendingPages * GIN_PAGE_FREESIZE;
+	if (pendingSize > cleanupSize * (Size) 1024)
 		needCleanup = true;
 
 	UnlockReleaseBuffer(metabuffer);
 
 	END_CRIT_SECTION();
 
+	/*
+	 * If autocleanup is enabled, ask autovacuum to clean up the pending list
+	 * rather than making this insertion wait for it.  Should autovacuum fall
+	 * behind so far that the list reaches twice its limit, fall back to
+	 * cleaning it ourselves, so that searches are not slowed down without
+	 * bound.
+	 */
+	if (needCleanup && GinGetUseAutoCleanup(index) &&
+		pendingSize <= 2 * cleanupSize * (Size) 1024 &&
+		AutoVacuumingActive() &&
+		AutoVacuumRequestWork(AVW_GINCleanPendingList,
+							  RelationGetRelid(index),
+							  InvalidBlockNumber))
+		needCleanup = false;
+
 	/*
 	 * Since it could contend with concurrent cleanup process we cleanup
 	 * pending list not forcibly.
@@ -240,15 +240,6 @@ typedef enum
  */
 #define MAX_EAGER_FREEZE_SUCCESS_RATE 0.2
 
-/*
- * On the assumption that different regions of the table tend to have
- * similarly aged data, once vacuum fails to freeze
- * vacuum_max_eager_freeze_failure_rate of the blocks in a region of size
- * EAGER_SCAN_REGION_SIZE, it suspends eager scanning until it has progressed
- * to another region of the table with potentially older data.
- */
-#define EAGER_SCAN_REGION_SIZE 4096
-
 /*
  * heap_vac_scan_next_block() sets these flags to communicate information
  * about the block it read to the caller.
@@ -940,6 +931,7 @@ heap_vacuum_rel(Relation rel, const VacuumParams params,
 						 Max(vacrel->new_live_tuples, 0),
 						 vacrel->recently_dead_tuples +
 						 vacrel->missed_dead_tuples,
+						 vacrel->vm_new_frozen_pages,
 						 starttime);
 	pgstat_progress_end_command();
 
@@ -364,6 +364,15 @@ btbeginscan(Relation rel, int nkeys, int norderbys)
 	so->killedItems = NULL;		/* until needed */
 	so->numKilled = 0;
 
+	so->lastLeaf = InvalidBlockNumber;
+	so->lastLeafMisses = 0;
+#ifdef USE_PREFETCH
+	so->prefetchMaximum = -1;	/* looked up by _bt_prefetch_heap */
+#else
+	so->prefetchMaximum = 0;
+#endif
+	so->prefetchVmBuffer = InvalidBuffer;
+
 	/*
 	 * We don't know yet whether the scan will be index-only, so we do not
 	 * allocate the tuple workspace arrays until btrescan.  However, we set up
@@ -425,6 +434,9 @@ btrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,
 				   RelationNeedsWAL(scan->indexRelation) &&
 				   scan->heapRelation != NULL);
 
+	so->prefetchDistance = 0;
+	so->prefetchPage = InvalidBlockNumber;
+
 	so->markItemIndex = -1;
 	so->needPrimScan = false;
 	so->scanBehind = false;
@@ -485,6 +497,9 @@ btendscan(IndexScanDesc scan)
 
 	/* No need to invalidate positions, the RAM is about to be freed. */
 
+	if (BufferIsValid(so->prefetchVmBuffer))
+		ReleaseBuffer(so->prefetchVmBuffer);
+
 	/* Release storage */
 	if (so->keyData != NULL)
 		pfree(so->keyData);
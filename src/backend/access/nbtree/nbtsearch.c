@@ -17,18 +17,30 @@
 
 #include "access/nbtree.h"
 #include "access/relscan.h"
+#include "access/visibilitymap.h"
 #include "access/xact.h"
+#include "catalog/catalog.h"
+#include "common/int.h"
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "storage/predicate.h"
+#include "utils/fmgrprotos.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
+#include "utils/spccache.h"
+
+/*
+ * Give up on starting from the last leaf page read after this many
+ * consecutive attempts that didn't pan out; see _bt_search_lastleaf.
+ */
+#define BT_LASTLEAF_MAX_MISSES	4
 
 
 static inline void _bt_drop_lock_and_maybe_pin(Relation rel, BTScanOpaque so);
 static Buffer _bt_moveright(Relation rel, Relation heaprel, BTScanInsert key,
 							Buffer buf, bool forupdate, BTStack stack,
 							int access);
+static bool _bt_search_lastleaf(IndexScanDesc scan, BTScanInsert key);
 static OffsetNumber _bt_binsrch(Relation rel, BTScanInsert key, Buffer buf);
 static int	_bt_binsrch_posting(BTScanInsert key, Page page,
 								OffsetNumber offnum);
@@ -42,7 +54,12 @@ static int	_bt_setuppostingitems(BTScanOpaque so, int itemIndex,
 static inline void _bt_savepostingitem(BTScanOpaque so, int itemIndex,
 									   OffsetNumber offnum,
 									   ItemPointer heapTid, int tupleOffset);
-static inline void _bt_returnitem(IndexScanDesc scan, BTScanOpaque so);
+static inline void _bt_returnitem(IndexScanDesc scan, BTScanOpaque so,
+								  ScanDirection dir);
+static void _bt_prefetch_heap(IndexScanDesc scan, BTScanOpaque so,
+							  ScanDirection dir);
+static inline void _bt_prefetch_item(IndexScanDesc scan, BTScanOpaque so,
+									 BTScanPosItem *item);
 static bool _bt_steppage(IndexScanDesc scan, ScanDirection dir);
 static bool _bt_readfirstpage(IndexScanDesc scan, OffsetNumber offnum,
 							  ScanDirection dir);
@@ -211,6 +228,72 @@ _bt_search(Relation rel, Relation heaprel, BTScanInsert key, Buffer *bufP,
 	return stack_in;
 }
 
+/*
+ *	_bt_search_lastleaf() -- Try to start from the last leaf page we read.
+ *
+ * The inner side of a nested loop join rescans the index once per outer row,
+ * and a scan with array keys starts a new primitive index scan whenever the
+ * next array element isn't on the current leaf page.  Either way, the new
+ * search often lands on the leaf page that the scan read last, and then the
+ * descent from the root is wasted work.
+ *
+ * So, before descending, check whether so->lastLeaf is still a live leaf
+ * page, whose first non-pivot tuple is < key, and whose high key doesn't
+ * require moving right (by the same test as _bt_moveright).  The items on a
+ * leaf page always lie within the page's key space, so if both hold, the
+ * page is where _bt_search would have taken us, no matter how the page might
+ * have been split, deleted or recycled since we last read it.
+ *
+ * Each failed attempt costs an extra buffer access, so once the shortcut has
+ * failed BT_LASTLEAF_MAX_MISSES times in a row, assume the scan's searches
+ * don't have the locality it relies on, and stop trying for its remainder.
+ *
+ * Returns true with so->currPos.buf pinned and read-locked on success.
+ */
+static bool
+_bt_search_lastleaf(IndexScanDesc scan, BTScanInsert key)
+{
+	Relation	rel = scan->indexRelation;
+	BTScanOpaque so = (BTScanOpaque) scan->opaque;
+	Buffer		buf;
+	Page		page;
+	BTPageOpaque opaque;
+	int32		cmpval = key->nextkey ? 0 : 1;
+
+	/*
+	 * Parallel scans must always start where the shared state says; and
+	 * pg_upgrade'd !heapkeyspace indexes can have duplicates of the first
+	 * item on the left sibling, so don't bother with those either.
+	 */
+	if (!BlockNumberIsValid(so->lastLeaf) || scan->parallel_scan != NULL ||
+		!key->heapkeyspace || so->lastLeafMisses >= BT_LASTLEAF_MAX_MISSES)
+		return false;
+
+	buf = ReadBuffer(rel, so->lastLeaf);
+	_bt_lockbuf(rel, buf, BT_READ);
+	page = BufferGetPage(buf);
+
+	if (!PageIsNew(page))
+	{
+		opaque = BTPageGetOpaque(page);
+
+		if (P_ISLEAF(opaque) && !P_IGNORE(opaque) &&
+			P_FIRSTDATAKEY(opaque) <= PageGetMaxOffsetNumber(page) &&
+			(P_RIGHTMOST(opaque) ||
+			 _bt_compare(rel, key, page, P_HIKEY) < cmpval) &&
+			_bt_compare(rel, key, page, P_FIRSTDATAKEY(opaque)) > 0)
+		{
+			so->currPos.buf = buf;
+			so->lastLeafMisses = 0;
+			return true;
+		}
+	}
+
+	_bt_relbuf(rel, buf);
+	so->lastLeafMisses++;
+	return false;
+}
+
 /*
  *	_bt_moveright() -- move right in the btree if necessary.
  *
@@ -766,11 +849,23 @@ _bt_compare(Relation rel,
 			 * _bt_compare as comparing the scankey to the index item, we have
 			 * to flip the sign of the comparison result.  (Unless it's a DESC
 			 * column, in which case we *don't* flip the sign.)
+			 *
+			 * The comparison functions of the most common integer-like
+			 * opclasses are open-coded here, saving a trip through fmgr on
+			 * every comparison made during a descent.
 			 */
-			result = DatumGetInt32(FunctionCall2Coll(&scankey->sk_func,
-													 scankey->sk_collation,
-													 datum,
-													 scankey->sk_argument));
+			if (scankey->sk_func.fn_addr == btint4cmp)
+				result = pg_cmp_s32(DatumGetInt32(datum),
+									DatumGetInt32(scankey->sk_argument));
+			else if (scankey->sk_func.fn_addr == btint8cmp ||
+					 scankey->sk_func.fn_addr == timestamp_cmp)
+				result = pg_cmp_s64(DatumGetInt64(datum),
+									DatumGetInt64(scankey->sk_argument));
+			else
+				result = DatumGetInt32(FunctionCall2Coll(&scankey->sk_func,
+														 scankey->sk_collation,
+														 datum,
+														 scankey->sk_argument));
 
 			if (!(scankey->sk_flags & SK_BT_DESC))
 				INVERT_COMPARE_RESULT(result);
@@ -946,7 +1041,7 @@ _bt_first(IndexScanDesc scan, ScanDirection dir)
 		if (!_bt_readnextpage(scan, blkno, lastcurrblkno, dir, true))
 			return false;
 
-		_bt_returnitem(scan, so);
+		_bt_returnitem(scan, so, dir);
 		return true;
 	}
 
@@ -1512,13 +1607,17 @@ _bt_first(IndexScanDesc scan, ScanDirection dir)
 
 	/*
 	 * Use the manufactured insertion scan key to descend the tree and
-	 * position ourselves on the target leaf page.
+	 * position ourselves on the target leaf page, unless the leaf page that
+	 * we read last is already the right one.
 	 */
 	Assert(ScanDirectionIsBackward(dir) == inskey.backward);
-	stack = _bt_search(rel, NULL, &inskey, &so->currPos.buf, BT_READ);
+	if (!_bt_search_lastleaf(scan, &inskey))
+	{
+		stack = _bt_search(rel, NULL, &inskey, &so->currPos.buf, BT_READ);
 
-	/* don't need to keep the stack around... */
-	_bt_freestack(stack);
+		/* don't need to keep the stack around... */
+		_bt_freestack(stack);
+	}
 
 	if (!BufferIsValid(so->currPos.buf))
 	{
@@ -1573,7 +1672,7 @@ _bt_first(IndexScanDesc scan, ScanDirection dir)
 	if (!_bt_readfirstpage(scan, offnum, dir))
 		return false;
 
-	_bt_returnitem(scan, so);
+	_bt_returnitem(scan, so, dir);
 	return true;
 }
 
@@ -1619,7 +1718,7 @@ _bt_next(IndexScanDesc scan, ScanDirection dir)
 		}
 	}
 
-	_bt_returnitem(scan, so);
+	_bt_returnitem(scan, so, dir);
 	return true;
 }
 
@@ -1662,6 +1761,7 @@ _bt_readpage(IndexScanDesc scan, ScanDirection dir, OffsetNumber offnum,
 	page = BufferGetPage(so->currPos.buf);
 	opaque = BTPageGetOpaque(page);
 	so->currPos.currPage = BufferGetBlockNumber(so->currPos.buf);
+	so->lastLeaf = so->currPos.currPage;
 	so->currPos.prevPage = opaque->btpo_prev;
 	so->currPos.nextPage = opaque->btpo_next;
 	/* delay setting so->currPos.lsn until _bt_drop_lock_and_maybe_pin */
@@ -2139,7 +2239,7 @@ _bt_savepostingitem(BTScanOpaque so, int itemIndex, OffsetNumber offnum,
  * index scan by setting the relevant fields in caller's index scan descriptor
  */
 static inline void
-_bt_returnitem(IndexScanDesc scan, BTScanOpaque so)
+_bt_returnitem(IndexScanDesc scan, BTScanOpaque so, ScanDirection dir)
 {
 	BTScanPosItem *currItem = &so->currPos.items[so->currPos.itemIndex];
 
@@ -2152,6 +2252,106 @@ _bt_returnitem(IndexScanDesc scan, BTScanOpaque so)
 	scan->xs_heaptid = currItem->heapTid;
 	if (so->currTuples)
 		scan->xs_itup = (IndexTuple) (so->currTuples + currItem->tupleOffset);
+
+	if (so->prefetchMaximum != 0)
+		_bt_prefetch_heap(scan, so, dir);
+}
+
+/*
+ *	_bt_prefetch_heap() -- Prefetch heap blocks for upcoming items
+ *
+ * The caller is about to fetch the heap tuple for currPos.itemIndex, one TID
+ * at a time and synchronously.  The TIDs that follow it on the same leaf page
+ * are already sitting in currPos.items[], so issue prefetch requests for
+ * their heap blocks, keeping up to prefetchDistance items ahead of the scan.
+ * The distance starts out small and grows by one per returned item up to
+ * prefetchMaximum, so that scans which stop after a few tuples (LIMIT, or a
+ * unique lookup) don't issue I/O for blocks they'll never read.
+ *
+ * We don't look past the end of the current leaf page.  A page usually holds
+ * enough TIDs to keep the I/O queue busy, and reading the next leaf page early
+ * would complicate locking and parallel scans for little benefit.
+ */
+static void
+_bt_prefetch_heap(IndexScanDesc scan, BTScanOpaque so, ScanDirection dir)
+{
+	BTScanPos	pos = &so->currPos;
+
+	/*
+	 * Work out the look-ahead limit on first use, and remember it for the
+	 * rest of the scan, rescans included.  Plain and index-only scans use
+	 * their heap's tablespace setting.  Bitmap scans have no heap relation,
+	 * and prefetch the heap themselves.
+	 *
+	 * Catalog scans just use the GUC: looking up the tablespace could need a
+	 * catalog index scan of its own, which would bring us right back here.
+	 */
+	if (unlikely(so->prefetchMaximum < 0))
+	{
+		if (scan->heapRelation == NULL)
+			so->prefetchMaximum = 0;
+		else if (IsCatalogRelation(scan->heapRelation))
+			so->prefetchMaximum = effective_io_concurrency;
+		else
+			so->prefetchMaximum =
+				get_tablespace_io_concurrency(scan->heapRelation->rd_rel->reltablespace);
+		if (so->prefetchMaximum == 0)
+			return;
+	}
+
+	/* Start over whenever the scan moves to another leaf page */
+	if (so->prefetchPage != pos->currPage)
+	{
+		so->prefetchPage = pos->currPage;
+		so->prefetchItem = pos->itemIndex;
+		so->prefetchBlock =
+			ItemPointerGetBlockNumber(&pos->items[pos->itemIndex].heapTid);
+	}
+
+	if (so->prefetchDistance < so->prefetchMaximum)
+		so->prefetchDistance++;
+
+	if (ScanDirectionIsForward(dir))
+	{
+		int			limit = Min(pos->itemIndex + so->prefetchDistance,
+								pos->lastItem);
+
+		if (so->prefetchItem <= pos->itemIndex)
+			so->prefetchItem = pos->itemIndex + 1;
+		while (so->prefetchItem <= limit)
+			_bt_prefetch_item(scan, so, &pos->items[so->prefetchItem++]);
+	}
+	else
+	{
+		int			limit = Max(pos->itemIndex - so->prefetchDistance,
+								pos->firstItem);
+
+		if (so->prefetchItem >= pos->itemIndex)
+			so->prefetchItem = pos->itemIndex - 1;
+		while (so->prefetchItem >= limit)
+			_bt_prefetch_item(scan, so, &pos->items[so->prefetchItem--]);
+	}
+}
+
+/*
+ * Prefetch the heap block of a single item, unless it's the same block as the
+ * previous item (common with a well-correlated index) or, in an index-only
+ * scan, the block is all-visible and will not be read at all.
+ */
+static inline void
+_bt_prefetch_item(IndexScanDesc scan, BTScanOpaque so, BTScanPosItem *item)
+{
+	BlockNumber blkno = ItemPointerGetBlockNumber(&item->heapTid);
+
+	if (blkno == so->prefetchBlock)
+		return;
+	so->prefetchBlock = blkno;
+
+	if (scan->xs_want_itup &&
+		VM_ALL_VISIBLE(scan->heapRelation, blkno, &so->prefetchVmBuffer))
+		return;
+
+	PrefetchBuffer(scan->heapRelation, MAIN_FORKNUM, blkno);
 }
 
 /*
@@ -2752,6 +2952,6 @@ _bt_endpoint(IndexScanDesc scan, ScanDirection dir)
 	if (!_bt_readfirstpage(scan, start, dir))
 		return false;
 
-	_bt_returnitem(scan, so);
+	_bt_returnitem(scan, so, dir);
 	return true;
 }
@@ -73,6 +73,7 @@
 #include "pg_trace.h"
 #include "pgstat.h"
 #include "port/atomics.h"
+#include "port/pg_iovec.h"
 #include "postmaster/bgwriter.h"
 #include "postmaster/startup.h"
 #include "postmaster/walsummarizer.h"
@@ -129,7 +130,7 @@ bool		wal_recycle = true;
 bool		log_checkpoints = true;
 int			wal_sync_method = DEFAULT_WAL_SYNC_METHOD;
 int			wal_level = WAL_LEVEL_REPLICA;
-int			CommitDelay = 0;	/* precommit delay in microseconds */
+int			CommitDelay = 0;	/* precommit delay in microseconds, or -1 */
 int			CommitSiblings = 5; /* # concurrent xacts needed to sleep */
 int			wal_retrieve_retry_interval = 5000;
 int			max_slot_wal_keep_size_mb = -1;
@@ -398,8 +399,13 @@ typedef struct XLogCtlInsert
 	 * previously inserted (or rather, reserved) record - it is copied to the
 	 * prev-link of the next record. These are stored as "usable byte
 	 * positions" rather than XLogRecPtrs (see XLogBytePosToRecPtr()).
+	 *
+	 * CurrBytePos is only ever changed while holding insertpos_lck, but it's
+	 * an atomic variable so that processes that merely want to know the
+	 * current insert position, notably WaitXLogInsertionsToFinish(), can read
+	 * it without acquiring the spinlock and competing with inserters.
 	 */
-	uint64		CurrBytePos;
+	pg_atomic_uint64 CurrBytePos;
 	uint64		PrevBytePos;
 
 	/*
@@ -462,6 +468,13 @@ typedef struct XLogCtlData
 	pg_time_t	lastSegSwitchTime;
 	XLogRecPtr	lastSegSwitchLSN;
 
+	/*
+	 * Moving average of the time taken by recent group commit flushes in
+	 * XLogFlush, in microseconds; used when commit_delay is -1.  Protected by
+	 * WALWriteLock.
+	 */
+	uint32		avgFlushTime;
+
 	/* These are accessed using atomics -- info_lck not needed */
 	pg_atomic_uint64 logInsertResult;	/* last byte + 1 inserted to buffers */
 	pg_atomic_uint64 logWriteResult;	/* last byte + 1 written out */
@@ -803,7 +816,7 @@ XLogInsertRecord(XLogRecData *rdata,
 	 *
 	 * 1. Reserve the right amount of space from the WAL. The current head of
 	 *	  reserved space is kept in Insert->CurrBytePos, and is protected by
-	 *	  insertpos_lck.
+	 *	  insertpos_lck (but can be read without it).
 	 *
 	 * 2. Copy the record to the reserved WAL space. This involves finding the
 	 *	  correct WAL buffer containing the reserved space, and copying the
@@ -1141,10 +1154,10 @@ ReserveXLogInsertLocation(int size, XLogRecPtr *StartPos, XLogRecPtr *EndPos,
 	 */
 	SpinLockAcquire(&Insert->insertpos_lck);
 
-	startbytepos = Insert->CurrBytePos;
+	startbytepos = pg_atomic_read_u64(&Insert->CurrBytePos);
 	endbytepos = startbytepos + size;
 	prevbytepos = Insert->PrevBytePos;
-	Insert->CurrBytePos = endbytepos;
+	pg_atomic_write_u64(&Insert->CurrBytePos, endbytepos);
 	Insert->PrevBytePos = startbytepos;
 
 	SpinLockRelease(&Insert->insertpos_lck);
@@ -1185,12 +1198,12 @@ ReserveXLogSwitch(XLogRecPtr *StartPos, XLogRecPtr *EndPos, XLogRecPtr *PrevPtr)
 	/*
 	 * These calculations are a bit heavy-weight to be done while holding a
 	 * spinlock, but since we're holding all the WAL insertion locks, there
-	 * are no other inserters competing for it. GetXLogInsertRecPtr() does
-	 * compete for it, but that's not called very frequently.
+	 * are no other inserters competing for it.  Readers of CurrBytePos don't
+	 * need the spinlock at all.
 	 */
 	SpinLockAcquire(&Insert->insertpos_lck);
 
-	startbytepos = Insert->CurrBytePos;
+	startbytepos = pg_atomic_read_u64(&Insert->CurrBytePos);
 
 	ptr = XLogBytePosToEndRecPtr(startbytepos);
 	if (XLogSegmentOffset(ptr, wal_segment_size) == 0)
@@ -1213,7 +1226,7 @@ ReserveXLogSwitch(XLogRecPtr *StartPos, XLogRecPtr *EndPos, XLogRecPtr *PrevPtr)
 		*EndPos += segleft;
 		endbytepos = XLogRecPtrToBytePos(*EndPos);
 	}
-	Insert->CurrBytePos = endbytepos;
+	pg_atomic_write_u64(&Insert->CurrBytePos, endbytepos);
 	Insert->PrevBytePos = startbytepos;
 
 	SpinLockRelease(&Insert->insertpos_lck);
@@ -1532,10 +1545,12 @@ WaitXLogInsertionsToFinish(XLogRecPtr upto)
 	if (upto <= inserted)
 		return inserted;
 
-	/* Read the current insert position */
-	SpinLockAcquire(&Insert->insertpos_lck);
-	bytepos = Insert->CurrBytePos;
-	SpinLockRelease(&Insert->insertpos_lck);
+	/*
+	 * Read the current insert position.  We don't need insertpos_lck for
+	 * that, but use a barrier so that we see at least all reservations that
+	 * happened before anything else we've observed.
+	 */
+	bytepos = pg_atomic_read_membarrier_u64(&Insert->CurrBytePos);
 	reservedUpto = XLogBytePosToEndRecPtr(bytepos);
 
 	/*
@@ -2522,9 +2537,10 @@ XLogWrite(XLogwrtRqst WriteRqst, TimeLineID tli, bool flexible)
 
 		/*
 		 * Dump the set if this will be the last loop iteration, or if we are
-		 * at the last page of the cache area (since the next page won't be
-		 * contiguous in memory), or if we are at the end of the logfile
-		 * segment.
+		 * at the end of the logfile segment, or if the set already covers
+		 * the whole cache area.  Wrapping around the end of the cache area
+		 * doesn't end the set: the pages on either side of the wraparound
+		 * are written together with one vectored write.
 		 */
 		last_iteration = WriteRqst.Write <= LogwrtResult.Write;
 
@@ -2532,19 +2548,31 @@ XLogWrite(XLogwrtRqst WriteRqst, TimeLineID tli, bool flexible)
 			(startoffset + npages * XLOG_BLCKSZ) >= wal_segment_size;
 
 		if (last_iteration ||
-			curridx == XLogCtl->XLogCacheBlck ||
+			npages > XLogCtl->XLogCacheBlck ||
 			finishing_seg)
 		{
-			char	   *from;
-			Size		nbytes;
+			struct iovec iov[2];
+			int			iovcnt;
+			int			npages_tail;
 			Size		nleft;
 			ssize_t		written;
 			instr_time	start;
 
-			/* OK to write the page(s) */
-			from = XLogCtl->pages + startidx * (Size) XLOG_BLCKSZ;
-			nbytes = npages * (Size) XLOG_BLCKSZ;
-			nleft = nbytes;
+			/*
+			 * OK to write the page(s).  If the set wraps around the end of
+			 * the cache area, its tail starts at the first cache page.
+			 */
+			npages_tail = Min(npages, XLogCtl->XLogCacheBlck + 1 - startidx);
+			iov[0].iov_base = XLogCtl->pages + startidx * (Size) XLOG_BLCKSZ;
+			iov[0].iov_len = npages_tail * (Size) XLOG_BLCKSZ;
+			iovcnt = 1;
+			if (npages > npages_tail)
+			{
+				iov[1].iov_base = XLogCtl->pages;
+				iov[1].iov_len = (npages - npages_tail) * (Size) XLOG_BLCKSZ;
+				iovcnt = 2;
+			}
+			nleft = npages * (Size) XLOG_BLCKSZ;
 			do
 			{
 				errno = 0;
@@ -2555,7 +2583,7 @@ XLogWrite(XLogwrtRqst WriteRqst, TimeLineID tli, bool flexible)
 				start = pgstat_prepare_io_time(track_wal_io_timing);
 
 				pgstat_report_wait_start(WAIT_EVENT_WAL_WRITE);
-				written = pg_pwrite(openLogFile, from, nleft, startoffset);
+				written = pg_pwritev(openLogFile, iov, iovcnt, startoffset);
 				pgstat_report_wait_end();
 
 				pgstat_count_io_op_time(IOOBJECT_WAL, IOCONTEXT_NORMAL,
@@ -2579,8 +2607,8 @@ XLogWrite(XLogwrtRqst WriteRqst, TimeLineID tli, bool flexible)
 									xlogfname, startoffset, nleft)));
 				}
 				nleft -= written;
-				from += written;
 				startoffset += written;
+				iovcnt = compute_remaining_iovec(iov, iov, iovcnt, written);
 			} while (nleft > 0);
 
 			npages = 0;
@@ -3001,11 +3029,23 @@ XLogFlush(XLogRecPtr record)
 		 *
 		 * We do not sleep if enableFsync is not turned on, nor if there are
 		 * fewer than CommitSiblings other backends with active transactions.
+		 *
+		 * If CommitDelay is -1, sleep for half the time recent flushes have
+		 * taken.  Backends that become ready to commit during that time
+		 * would otherwise have had to wait for a whole further flush, so on
+		 * average this lets them join the group at no extra cost to them;
+		 * on fast storage the delay shrinks accordingly.
 		 */
-		if (CommitDelay > 0 && enableFsync &&
+		if (CommitDelay != 0 && enableFsync &&
 			MinimumActiveBackends(CommitSiblings))
 		{
-			pg_usleep(CommitDelay);
+			int			delay = CommitDelay;
+
+			if (delay < 0)
+				delay = Min(XLogCtl->avgFlushTime / 2, MAX_COMMIT_DELAY);
+
+			if (delay > 0)
+				pg_usleep(delay);
 
 			/*
 			 * Re-check how far we can now flush the WAL. It's generally not
@@ -3024,7 +3064,22 @@ XLogFlush(XLogRecPtr record)
 		WriteRqst.Write = insertpos;
 		WriteRqst.Flush = insertpos;
 
-		XLogWrite(WriteRqst, insertTLI, false);
+		if (CommitDelay < 0 && enableFsync)
+		{
+			instr_time	start;
+			instr_time	duration;
+			uint64		elapsed;
+
+			INSTR_TIME_SET_CURRENT(start);
+			XLogWrite(WriteRqst, insertTLI, false);
+			INSTR_TIME_SET_CURRENT(duration);
+			INSTR_TIME_SUBTRACT(duration, start);
+
+			elapsed = Min(INSTR_TIME_GET_MICROSEC(duration), PG_UINT32_MAX);
+			XLogCtl->avgFlushTime = ((uint64) XLogCtl->avgFlushTime * 7 + elapsed) / 8;
+		}
+		else
+			XLogWrite(WriteRqst, insertTLI, false);
 
 		LWLockRelease(WALWriteLock);
 		/* done */
@@ -5180,6 +5235,7 @@ XLOGShmemInit(void)
 	XLogCtl->WalWriterSleeping = false;
 
 	SpinLockInit(&XLogCtl->Insert.insertpos_lck);
+	pg_atomic_init_u64(&XLogCtl->Insert.CurrBytePos, 0);
 	SpinLockInit(&XLogCtl->info_lck);
 	pg_atomic_init_u64(&XLogCtl->logInsertResult, InvalidXLogRecPtr);
 	pg_atomic_init_u64(&XLogCtl->logWriteResult, InvalidXLogRecPtr);
@@ -6185,7 +6241,7 @@ StartupXLOG(void)
 	 */
 	Insert = &XLogCtl->Insert;
 	Insert->PrevBytePos = XLogRecPtrToBytePos(endOfRecoveryInfo->lastRec);
-	Insert->CurrBytePos = XLogRecPtrToBytePos(EndOfLog);
+	pg_atomic_write_u64(&Insert->CurrBytePos, XLogRecPtrToBytePos(EndOfLog));
 
 	/*
 	 * Tricky point here: lastPage contains the *last* block that the LastRec
@@ -7174,7 +7230,7 @@ CreateCheckPoint(int flags)
 
 	if (shutdown)
 	{
-		XLogRecPtr	curInsert = XLogBytePosToRecPtr(Insert->CurrBytePos);
+		XLogRecPtr	curInsert = XLogBytePosToRecPtr(pg_atomic_read_u64(&Insert->CurrBytePos));
 
 		/*
 		 * Compute new REDO record ptr = location of next XLOG record.
@@ -9600,9 +9656,7 @@ GetXLogInsertRecPtr(void)
 	XLogCtlInsert *Insert = &XLogCtl->Insert;
 	uint64		current_bytepos;
 
-	SpinLockAcquire(&Insert->insertpos_lck);
-	current_bytepos = Insert->CurrBytePos;
-	SpinLockRelease(&Insert->insertpos_lck);
+	current_bytepos = pg_atomic_read_membarrier_u64(&Insert->CurrBytePos);
 
 	return XLogBytePosToRecPtr(current_bytepos);
 }
@@ -71,7 +71,9 @@
 #include "mb/pg_wchar.h"
 #include "miscadmin.h"
 #include "pgstat.h"
+#include "port/pg_bitutils.h"
 #include "port/pg_bswap.h"
+#include "port/simd.h"
 #include "utils/builtins.h"
 #include "utils/rel.h"
 
@@ -1236,6 +1238,48 @@ CopyReadLine(CopyFromState cstate, bool is_csv)
 	return result;
 }
 
+/*
+ * CopyChunkFindSpecial
+ *
+ * Return the offset of the first of the sizeof(Vector8) bytes at s that
+ * equals one of c1, c2, c3 or c4, or -1 if there is no such byte.  Callers
+ * that need fewer than four characters repeat one of them.
+ */
+static inline int
+CopyChunkFindSpecial(const char *s, uint8 c1, uint8 c2, uint8 c3, uint8 c4)
+{
+	Vector8		chunk;
+
+	vector8_load(&chunk, (const uint8 *) s);
+#ifndef USE_NO_SIMD
+	{
+		Vector8		hits;
+		uint32		mask;
+
+		hits = vector8_or(vector8_or(vector8_eq(chunk, vector8_broadcast(c1)),
+									 vector8_eq(chunk, vector8_broadcast(c2))),
+						  vector8_or(vector8_eq(chunk, vector8_broadcast(c3)),
+									 vector8_eq(chunk, vector8_broadcast(c4))));
+		mask = vector8_highbit_mask(hits);
+		if (mask == 0)
+			return -1;
+		return pg_rightmost_one_pos32(mask);
+	}
+#else
+	if (!vector8_has(chunk, c1) && !vector8_has(chunk, c2) &&
+		!vector8_has(chunk, c3) && !vector8_has(chunk, c4))
+		return -1;
+	for (int i = 0; i < (int) sizeof(Vector8); i++)
+	{
+		uint8		b = (uint8) s[i];
+
+		if (b == c1 || b == c2 || b == c3 || b == c4)
+			return i;
+	}
+	pg_unreachable();
+#endif
+}
+
 /*
  * CopyReadLineText - inner loop of CopyReadLine for text mode
  */
@@ -1255,6 +1299,11 @@ CopyReadLineText(CopyFromState cstate, bool is_csv)
 	char		quotec = '\0';
 	char		escapec = '\0';
 
+	/* characters the chunked skip below must stop at */
+	uint8		specialc;
+	uint8		specialc2;
+	int			simd_resume_ptr = 0;
+
 	if (is_csv)
 	{
 		quotec = cstate->opts.quote[0];
@@ -1263,6 +1312,8 @@ CopyReadLineText(CopyFromState cstate, bool is_csv)
 		if (quotec == escapec)
 			escapec = '\0';
 	}
+	specialc = (uint8) (is_csv ? quotec : '\\');
+	specialc2 = escapec != '\0' ? (uint8) escapec : specialc;
 
 	/*
 	 * The objective of this loop is to transfer the entire next input line
@@ -1315,6 +1366,7 @@ CopyReadLineText(CopyFromState cstate, bool is_csv)
 			hit_eof = cstate->input_reached_eof;
 			input_buf_ptr = cstate->input_buf_index;
 			copy_buf_len = cstate->input_buf_len;
+			simd_resume_ptr = 0;
 
 			/*
 			 * If we are completely out of data, break out of the loop,
@@ -1328,6 +1380,39 @@ CopyReadLineText(CopyFromState cstate, bool is_csv)
 			need_data = false;
 		}
 
+		/*
+		 * Skip quickly over runs of ordinary characters.  None of the bytes
+		 * in a chunk that contains no newline, quote, escape or backslash
+		 * can change our state, except that in CSV mode they end any escape
+		 * sequence; so all we have to do is advance past them.
+		 *
+		 * Once a chunk turns out to contain a special character, jump
+		 * straight to it and leave the rest of that chunk to the
+		 * byte-at-a-time code below.  Testing the chunk again for every byte
+		 * would make input with short fields slower than not trying at all.
+		 */
+		if (input_buf_ptr >= simd_resume_ptr)
+		{
+			while (copy_buf_len - input_buf_ptr > (int) sizeof(Vector8))
+			{
+				int			off;
+
+				off = CopyChunkFindSpecial(&copy_input_buf[input_buf_ptr],
+										   '\n', '\r', specialc, specialc2);
+				if (off < 0)
+				{
+					input_buf_ptr += sizeof(Vector8);
+					last_was_esc = false;
+					continue;
+				}
+				if (off > 0)
+					last_was_esc = false;
+				simd_resume_ptr = input_buf_ptr + sizeof(Vector8);
+				input_buf_ptr += off;
+				break;
+			}
+		}
+
 		/* OK to fetch a character */
 		prev_raw_ptr = input_buf_ptr;
 		c = copy_input_buf[input_buf_ptr++];
@@ -1577,6 +1662,7 @@ CopyReadAttributesText(CopyFromState cstate)
 	char	   *output_ptr;
 	char	   *cur_ptr;
 	char	   *line_end_ptr;
+	char	   *simd_resume_ptr;
 
 	/*
 	 * We need a special case for zero-column tables: check that the input
@@ -1607,6 +1693,7 @@ CopyReadAttributesText(CopyFromState cstate)
 	/* set pointer variables for loop */
 	cur_ptr = cstate->line_buf.data;
 	line_end_ptr = cstate->line_buf.data + cstate->line_buf.len;
+	simd_resume_ptr = cur_ptr;
 
 	/* Outer loop iterates over fields */
 	fieldno = 0;
@@ -1645,6 +1732,35 @@ CopyReadAttributesText(CopyFromState cstate)
 		{
 			char		c;
 
+			/*
+			 * Copy chunks of input containing neither delimiters nor
+			 * backslashes straight to the output.  As in CopyReadLineText,
+			 * once a chunk contains one, copy up to it and don't retry until
+			 * the scalar code has moved past that chunk.
+			 */
+			if (cur_ptr >= simd_resume_ptr)
+			{
+				while (line_end_ptr - cur_ptr >= (ptrdiff_t) sizeof(Vector8))
+				{
+					int			off;
+
+					off = CopyChunkFindSpecial(cur_ptr, (uint8) delimc, '\\',
+											   '\\', '\\');
+					if (off < 0)
+					{
+						memcpy(output_ptr, cur_ptr, sizeof(Vector8));
+						output_ptr += sizeof(Vector8);
+						cur_ptr += sizeof(Vector8);
+						continue;
+					}
+					memcpy(output_ptr, cur_ptr, off);
+					output_ptr += off;
+					simd_resume_ptr = cur_ptr + sizeof(Vector8);
+					cur_ptr += off;
+					break;
+				}
+			}
+
 			end_ptr = cur_ptr;
 			if (cur_ptr >= line_end_ptr)
 				break;
@@ -145,6 +145,7 @@ static const char *explain_get_index_name(Oid indexId);
 static bool peek_buffer_usage(ExplainState *es, const BufferUsage *usage);
 static void show_buffer_usage(ExplainState *es, const BufferUsage *usage);
 static void show_wal_usage(ExplainState *es, const WalUsage *usage);
+static void show_cpu_usage(ExplainState *es, const CpuUsage *usage);
 static void show_memory_counters(ExplainState *es,
 								 const MemoryContextCounters *mem_counters);
 static void ExplainIndexScanDetails(Oid indexid, ScanDirection indexorderdir,
@@ -516,6 +517,8 @@ ExplainOnePlan(PlannedStmt *plannedstmt, IntoClause *into, ExplainState *es,
 		instrument_option |= INSTRUMENT_BUFFERS;
 	if (es->wal)
 		instrument_option |= INSTRUMENT_WAL;
+	if (es->cpu)
+		instrument_option |= INSTRUMENT_CPU;
 
 	/*
 	 * We always collect timing for the entire statement, even when node-level
@@ -2281,14 +2284,17 @@ ExplainNode(PlanState *planstate, List *ancestors,
 		}
 	}
 
-	/* Show buffer/WAL usage */
+	/* Show buffer/WAL/CPU usage */
 	if (es->buffers && planstate->instrument)
 		show_buffer_usage(es, &planstate->instrument->bufusage);
 	if (es->wal && planstate->instrument)
 		show_wal_usage(es, &planstate->instrument->walusage);
+	if (es->cpu && planstate->instrument)
+		show_cpu_usage(es, &planstate->instrument->cpuusage);
 
-	/* Prepare per-worker buffer/WAL usage */
-	if (es->workers_state && (es->buffers || es->wal) && es->verbose)
+	/* Prepare per-worker buffer/WAL/CPU usage */
+	if (es->workers_state && (es->buffers || es->wal || es->cpu) &&
+		es->verbose)
 	{
 		WorkerInstrumentation *w = planstate->worker_instrument;
 
@@ -2305,6 +2311,8 @@ ExplainNode(PlanState *planstate, List *ancestors,
 				show_buffer_usage(es, &instrument->bufusage);
 			if (es->wal)
 				show_wal_usage(es, &instrument->walusage);
+			if (es->cpu)
+				show_cpu_usage(es, &instrument->cpuusage);
 			ExplainCloseWorker(n, es);
 		}
 	}
@@ -3737,6 +3745,9 @@ show_hashagg_info(AggState *aggstate, ExplainState *es)
 		{
 			ExplainPropertyInteger("HashAgg Batches", NULL,
 								   aggstate->hash_batches_used, es);
+			if (aggstate->hash_partial_flush)
+				ExplainPropertyInteger("HashAgg Flushes", NULL,
+									   aggstate->hash_flushes, es);
 			ExplainPropertyInteger("Peak Memory Usage", "kB", memPeakKb, es);
 			ExplainPropertyInteger("Disk Usage", "kB",
 								   aggstate->hash_disk_used, es);
@@ -3766,8 +3777,12 @@ show_hashagg_info(AggState *aggstate, ExplainState *es)
 			else
 				appendStringInfoSpaces(es->str, 2);
 
-			appendStringInfo(es->str, "Batches: %d  Memory Usage: " INT64_FORMAT "kB",
-							 aggstate->hash_batches_used, memPeakKb);
+			appendStringInfo(es->str, "Batches: %d", aggstate->hash_batches_used);
+			if (aggstate->hash_flushes > 0)
+				appendStringInfo(es->str, "  Flushes: %d",
+								 aggstate->hash_flushes);
+			appendStringInfo(es->str, "  Memory Usage: " INT64_FORMAT "kB",
+							 memPeakKb);
 			gotone = true;
 
 			/* Only display disk usage if we spilled to disk */
@@ -3790,6 +3805,7 @@ show_hashagg_info(AggState *aggstate, ExplainState *es)
 			AggregateInstrumentation *sinstrument;
 			uint64		hash_disk_used;
 			int			hash_batches_used;
+			int			hash_flushes;
 
 			sinstrument = &aggstate->shared_info->sinstrument[n];
 			/* Skip workers that didn't do anything */
@@ -3797,6 +3813,7 @@ show_hashagg_info(AggState *aggstate, ExplainState *es)
 				continue;
 			hash_disk_used = sinstrument->hash_disk_used;
 			hash_batches_used = sinstrument->hash_batches_used;
+			hash_flushes = sinstrument->hash_flushes;
 			memPeakKb = BYTES_TO_KILOBYTES(sinstrument->hash_mem_peak);
 
 			if (es->workers_state)
@@ -3806,8 +3823,11 @@ show_hashagg_info(AggState *aggstate, ExplainState *es)
 			{
 				ExplainIndentText(es);
 
-				appendStringInfo(es->str, "Batches: %d  Memory Usage: " INT64_FORMAT "kB",
-								 hash_batches_used, memPeakKb);
+				appendStringInfo(es->str, "Batches: %d", hash_batches_used);
+				if (hash_flushes > 0)
+					appendStringInfo(es->str, "  Flushes: %d", hash_flushes);
+				appendStringInfo(es->str, "  Memory Usage: " INT64_FORMAT "kB",
+								 memPeakKb);
 
 				/* Only display disk usage if we spilled to disk */
 				if (hash_batches_used > 1)
@@ -3819,6 +3839,9 @@ show_hashagg_info(AggState *aggstate, ExplainState *es)
 			{
 				ExplainPropertyInteger("HashAgg Batches", NULL,
 									   hash_batches_used, es);
+				if (aggstate->hash_partial_flush)
+					ExplainPropertyInteger("HashAgg Flushes", NULL,
+										   hash_flushes, es);
 				ExplainPropertyInteger("Peak Memory Usage", "kB", memPeakKb,
 									   es);
 				ExplainPropertyInteger("Disk Usage", "kB", hash_disk_used, es);
@@ -4291,6 +4314,49 @@ show_wal_usage(ExplainState *es, const WalUsage *usage)
 	}
 }
 
+/*
+ * Show hardware performance counter readings.
+ */
+static void
+show_cpu_usage(ExplainState *es, const CpuUsage *usage)
+{
+	if (es->format == EXPLAIN_FORMAT_TEXT)
+	{
+		/* Show only positive counter values. */
+		if ((usage->cycles > 0) || (usage->instructions > 0) ||
+			(usage->cache_misses > 0) || (usage->branch_misses > 0))
+		{
+			ExplainIndentText(es);
+			appendStringInfoString(es->str, "CPU:");
+
+			if (usage->cycles > 0)
+				appendStringInfo(es->str, " cycles=%" PRId64,
+								 usage->cycles);
+			if (usage->instructions > 0)
+				appendStringInfo(es->str, " instructions=%" PRId64,
+								 usage->instructions);
+			if (usage->cache_misses > 0)
+				appendStringInfo(es->str, " cache misses=%" PRId64,
+								 usage->cache_misses);
+			if (usage->branch_misses > 0)
+				appendStringInfo(es->str, " branch misses=%" PRId64,
+								 usage->branch_misses);
+			appendStringInfoChar(es->str, '\n');
+		}
+	}
+	else
+	{
+		ExplainPropertyInteger("CPU Cycles", NULL,
+							   usage->cycles, es);
+		ExplainPropertyInteger("CPU Instructions", NULL,
+							   usage->instructions, es);
+		ExplainPropertyInteger("CPU Cache Misses", NULL,
+							   usage->cache_misses, es);
+		ExplainPropertyInteger("CPU Branch Misses", NULL,
+							   usage->branch_misses, es);
+	}
+}
+
 /*
  * Show memory usage details.
  */
@@ -47,6 +47,7 @@
 #include "utils/acl.h"
 #include "utils/array.h"
 #include "utils/builtins.h"
+#include "utils/fmgroids.h"
 #include "utils/jsonfuncs.h"
 #include "utils/jsonpath.h"
 #include "utils/lsyscache.h"
@@ -4064,6 +4065,9 @@ ExecBuildAggTransCall(ExprState *state, AggState *aggstate,
 	 * Otherwise we call EEOP_AGG_PLAIN_TRANS{,_BYVAL}, which does not have to
 	 * perform either of the above checks.
 	 *
+	 * The transition functions of count() and sum(int4) are inlined into
+	 * EEOP_AGG_PLAIN_TRANS_{INT8INC,INT4_SUM} steps instead, when possible.
+	 *
 	 * Having steps with overlapping responsibilities is not nice, but
 	 * aggregations are very performance sensitive, making this worthwhile.
 	 *
@@ -4079,8 +4083,22 @@ ExecBuildAggTransCall(ExprState *state, AggState *aggstate,
 	{
 		if (pertrans->transtypeByVal)
 		{
-			if (fcinfo->flinfo->fn_strict &&
-				pertrans->initValueIsNull)
+			Oid			transfn_oid = fcinfo->flinfo->fn_oid;
+
+			/*
+			 * A few very common, very cheap transition functions have
+			 * inlined implementations.  These must match the generic step
+			 * that would otherwise be chosen below.
+			 */
+			if ((transfn_oid == F_INT8INC || transfn_oid == F_INT8INC_ANY) &&
+				fcinfo->flinfo->fn_strict &&
+				!pertrans->initValueIsNull)
+				scratch->opcode = EEOP_AGG_PLAIN_TRANS_INT8INC;
+			else if (transfn_oid == F_INT4_SUM &&
+					 !fcinfo->flinfo->fn_strict)
+				scratch->opcode = EEOP_AGG_PLAIN_TRANS_INT4_SUM;
+			else if (fcinfo->flinfo->fn_strict &&
+					 pertrans->initValueIsNull)
 				scratch->opcode = EEOP_AGG_PLAIN_TRANS_INIT_STRICT_BYVAL;
 			else if (fcinfo->flinfo->fn_strict)
 				scratch->opcode = EEOP_AGG_PLAIN_TRANS_STRICT_BYVAL;
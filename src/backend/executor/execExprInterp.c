@@ -59,6 +59,7 @@
 #include "access/heaptoast.h"
 #include "catalog/pg_type.h"
 #include "commands/sequence.h"
+#include "common/int.h"
 #include "executor/execExpr.h"
 #include "executor/nodeSubplan.h"
 #include "funcapi.h"
@@ -174,6 +175,7 @@ static Datum ExecJustHashInnerVar(ExprState *state, ExprContext *econtext, bool
 static Datum ExecJustHashOuterVarVirt(ExprState *state, ExprContext *econtext, bool *isnull);
 static Datum ExecJustHashInnerVarVirt(ExprState *state, ExprContext *econtext, bool *isnull);
 static Datum ExecJustHashOuterVarStrict(ExprState *state, ExprContext *econtext, bool *isnull);
+static Datum ExecJustQualScanVarStrictFunc(ExprState *state, ExprContext *econtext, bool *isnull);
 
 /* execution helper functions */
 static pg_attribute_always_inline void ExecAggPlainTransByVal(AggState *aggstate,
@@ -295,6 +297,17 @@ ExecReadyInterpretedExpr(ExprState *state)
 			state->evalfunc_private = (void *) ExecJustHashInnerVarWithIV;
 			return;
 		}
+		else if (step0 == EEOP_SCAN_FETCHSOME &&
+				 step1 == EEOP_SCAN_VAR &&
+				 (step2 == EEOP_FUNCEXPR_STRICT ||
+				  step2 == EEOP_FUNCEXPR_STRICT_1 ||
+				  step2 == EEOP_FUNCEXPR_STRICT_2) &&
+				 step3 == EEOP_QUAL)
+		{
+			/* a qual like "var op const", the arguments being var and consts */
+			state->evalfunc_private = ExecJustQualScanVarStrictFunc;
+			return;
+		}
 	}
 	else if (state->steps_len == 4)
 	{
@@ -588,6 +601,8 @@ ExecInterpExpr(ExprState *state, ExprContext *econtext, bool *isnull)
 		&&CASE_EEOP_AGG_PLAIN_TRANS_INIT_STRICT_BYREF,
 		&&CASE_EEOP_AGG_PLAIN_TRANS_STRICT_BYREF,
 		&&CASE_EEOP_AGG_PLAIN_TRANS_BYREF,
+		&&CASE_EEOP_AGG_PLAIN_TRANS_INT8INC,
+		&&CASE_EEOP_AGG_PLAIN_TRANS_INT4_SUM,
 		&&CASE_EEOP_AGG_PRESORTED_DISTINCT_SINGLE,
 		&&CASE_EEOP_AGG_PRESORTED_DISTINCT_MULTI,
 		&&CASE_EEOP_AGG_ORDERED_TRANS_DATUM,
@@ -2225,6 +2240,61 @@ ExecInterpExpr(ExprState *state, ExprContext *econtext, bool *isnull)
 			EEO_NEXT();
 		}
 
+		/*
+		 * Inlined transition functions for count() and sum(int4).  These
+		 * are among the most common aggregates, and their transition
+		 * functions are cheap enough that the function call overhead of
+		 * the generic steps dominates.  They are only used when the
+		 * transition type is pass-by-value.
+		 */
+		EEO_CASE(EEOP_AGG_PLAIN_TRANS_INT8INC)
+		{
+			AggState   *aggstate = castNode(AggState, state->parent);
+			AggStatePerGroup pergroup =
+				&aggstate->all_pergroups[op->d.agg_trans.setoff][op->d.agg_trans.transno];
+
+			Assert(op->d.agg_trans.pertrans->transtypeByVal);
+
+			/* int8inc() and int8inc_any() are strict, cf. STRICT_BYVAL */
+			if (likely(!pergroup->transValueIsNull))
+			{
+				int64		newval;
+
+				if (unlikely(pg_add_s64_overflow(DatumGetInt64(pergroup->transValue),
+												 1, &newval)))
+					ereport(ERROR,
+							(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+							 errmsg("bigint out of range")));
+				pergroup->transValue = Int64GetDatum(newval);
+			}
+
+			EEO_NEXT();
+		}
+
+		EEO_CASE(EEOP_AGG_PLAIN_TRANS_INT4_SUM)
+		{
+			AggState   *aggstate = castNode(AggState, state->parent);
+			AggStatePerTrans pertrans = op->d.agg_trans.pertrans;
+			AggStatePerGroup pergroup =
+				&aggstate->all_pergroups[op->d.agg_trans.setoff][op->d.agg_trans.transno];
+			NullableDatum *input = &pertrans->transfn_fcinfo->args[1];
+
+			Assert(pertrans->transtypeByVal);
+
+			/* same logic as int4_sum(); leave sum unchanged if input is null */
+			if (!input->isnull)
+			{
+				int64		newval = (int64) DatumGetInt32(input->value);
+
+				if (!pergroup->transValueIsNull)
+					newval += DatumGetInt64(pergroup->transValue);
+				pergroup->transValue = Int64GetDatum(newval);
+				pergroup->transValueIsNull = false;
+			}
+
+			EEO_NEXT();
+		}
+
 		EEO_CASE(EEOP_AGG_PRESORTED_DISTINCT_SINGLE)
 		{
 			AggStatePerTrans pertrans = op->d.agg_presorted_distinctcheck.pertrans;
@@ -2579,6 +2649,45 @@ ExecJustScanVar(ExprState *state, ExprContext *econtext, bool *isnull)
 	return ExecJustVarImpl(state, econtext->ecxt_scantuple, isnull);
 }
 
+/*
+ * Evaluate a qual consisting of a single strict function call, whose only
+ * non-constant argument is a scan Var, e.g. "WHERE col < 42".  The function's
+ * constant arguments were stored in its fcinfo at expression init time.
+ */
+static Datum
+ExecJustQualScanVarStrictFunc(ExprState *state, ExprContext *econtext,
+							  bool *isnull)
+{
+	ExprEvalStep *varop = &state->steps[1];
+	ExprEvalStep *funcop = &state->steps[2];
+	FunctionCallInfo fcinfo = funcop->d.func.fcinfo_data;
+	NullableDatum *args = fcinfo->args;
+	TupleTableSlot *scanslot = econtext->ecxt_scantuple;
+	Datum		d;
+
+	CheckOpSlotCompatibility(&state->steps[0], scanslot);
+
+	/* the Var step stores directly into one of the function's arguments */
+	*varop->resvalue = slot_getattr(scanslot, varop->d.var.attnum + 1,
+									varop->resnull);
+
+	/* as in EEOP_QUAL, a NULL or false result yields false */
+	*isnull = false;
+
+	for (int argno = 0; argno < funcop->d.func.nargs; argno++)
+	{
+		if (args[argno].isnull)
+			return BoolGetDatum(false);
+	}
+
+	fcinfo->isnull = false;
+	d = funcop->d.func.fn_addr(fcinfo);
+	if (fcinfo->isnull || !DatumGetBool(d))
+		return BoolGetDatum(false);
+
+	return BoolGetDatum(true);
+}
+
 /* implementation of ExecJustAssign(Inner|Outer|Scan)Var */
 static pg_attribute_always_inline Datum
 ExecJustAssignVarImpl(ExprState *state, TupleTableSlot *inslot, bool *isnull)
@@ -1448,6 +1448,18 @@ ParallelQueryMain(dsm_segment *seg, shm_toc *toc)
 	instrumentation = shm_toc_lookup(toc, PARALLEL_KEY_INSTRUMENTATION, true);
 	if (instrumentation != NULL)
 		instrument_options = instrumentation->instrument_options;
+
+	/*
+	 * The leader has checked that it can read hardware performance counters,
+	 * but we need counters of our own.  If we can't open them, fail rather
+	 * than let our share of the work be counted as zero.
+	 */
+	if ((instrument_options & INSTRUMENT_CPU) && !InstrCpuUsageAvailable())
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("hardware performance counters are not available"),
+				 errhint("On Linux, check the setting of kernel.perf_event_paranoid.")));
+
 	jit_instrumentation = shm_toc_lookup(toc, PARALLEL_KEY_JIT_INSTRUMENTATION,
 										 true);
 	queryDesc = ExecParallelGetQueryDesc(toc, receiver, instrument_options);
@@ -1104,6 +1104,100 @@ slot_deform_heap_tuple_internal(TupleTableSlot *slot, HeapTuple tuple,
 	return natts;
 }
 
+/*
+ * slot_compute_fixed_prefix
+ *		Compute the number of leading attributes of the slot's descriptor that
+ *		are fixed-width, and hence are always stored at the same offset in a
+ *		tuple that has no nulls among them.  Their attcacheoff is set as a
+ *		side effect, exactly as slot_deform_heap_tuple_internal() would.
+ *
+ * The result is remembered in the slot, so this needs to be done only once
+ * per slot (and descriptor).
+ */
+static pg_noinline int
+slot_compute_fixed_prefix(TupleTableSlot *slot)
+{
+	TupleDesc	tupleDesc = slot->tts_tupleDescriptor;
+	uint32		off = 0;
+	int			attnum;
+
+	for (attnum = 0; attnum < tupleDesc->natts; attnum++)
+	{
+		CompactAttribute *thisatt = TupleDescCompactAttr(tupleDesc, attnum);
+
+		if (thisatt->attlen <= 0)
+			break;
+
+		off = att_nominal_alignby(off, thisatt->attalignby);
+		thisatt->attcacheoff = off;
+		off += thisatt->attlen;
+	}
+
+	slot->tts_nfixed = attnum;
+
+	return attnum;
+}
+
+/*
+ * slot_deform_fixed_prefix
+ *		Deform the first natts attributes of a tuple, all of which are known
+ *		to be non-null and stored at their cached offset.
+ *
+ * This avoids all the per-attribute bookkeeping slot_deform_heap_tuple_internal
+ * has to do to find out where each attribute starts.  Returns the offset just
+ * past the last deformed attribute.
+ */
+static pg_attribute_always_inline uint32
+slot_deform_fixed_prefix(TupleTableSlot *slot, HeapTuple tuple, int natts)
+{
+	TupleDesc	tupleDesc = slot->tts_tupleDescriptor;
+	Datum	   *values = slot->tts_values;
+	HeapTupleHeader tup = tuple->t_data;
+	char	   *tp = (char *) tup + tup->t_hoff;
+	CompactAttribute *thisatt = NULL;
+
+	Assert(natts > 0);
+
+	for (int attnum = 0; attnum < natts; attnum++)
+	{
+		thisatt = TupleDescCompactAttr(tupleDesc, attnum);
+
+		Assert(thisatt->attlen > 0 && thisatt->attcacheoff >= 0);
+		values[attnum] = fetchatt(thisatt, tp + thisatt->attcacheoff);
+	}
+	memset(slot->tts_isnull, false, natts * sizeof(bool));
+
+	return thisatt->attcacheoff + thisatt->attlen;
+}
+
+/*
+ * att_nonull_prefix
+ *		Check that none of the first natts attributes are null according to
+ *		the given null bitmap.
+ */
+static inline bool
+att_nonull_prefix(int natts, const bits8 *bp)
+{
+	int			nbytes = natts / BITS_PER_BYTE;
+	int			nbits = natts % BITS_PER_BYTE;
+
+	for (int i = 0; i < nbytes; i++)
+	{
+		if (bp[i] != 0xFF)
+			return false;
+	}
+
+	if (nbits != 0)
+	{
+		bits8		mask = (1 << nbits) - 1;
+
+		if ((bp[nbytes] & mask) != mask)
+			return false;
+	}
+
+	return true;
+}
+
 /*
  * slot_deform_heap_tuple
  *		Given a TupleTableSlot, extract data from the slot's physical tuple
@@ -1137,9 +1231,28 @@ slot_deform_heap_tuple(TupleTableSlot *slot, HeapTuple tuple, uint32 *offp,
 	attnum = slot->tts_nvalid;
 	if (attnum == 0)
 	{
+		int			nfixed = slot->tts_nfixed;
+
 		/* Start from the first attribute */
 		off = 0;
 		slow = false;
+
+		/*
+		 * If the tuple starts with fixed-width attributes that aren't null,
+		 * deform those in one go.  It's common for tables to have all (or
+		 * all of the leading) columns fixed-width, so this is worth having a
+		 * precomputed fast path for.
+		 */
+		if (unlikely(nfixed < 0))
+			nfixed = slot_compute_fixed_prefix(slot);
+		nfixed = Min(nfixed, natts);
+
+		if (nfixed > 0 &&
+			(!hasnulls || att_nonull_prefix(nfixed, tuple->t_data->t_bits)))
+		{
+			off = slot_deform_fixed_prefix(slot, tuple, nfixed);
+			attnum = nfixed;
+		}
 	}
 	else
 	{
@@ -1328,6 +1441,7 @@ MakeTupleTableSlot(TupleDesc tupleDesc,
 	slot->tts_tupleDescriptor = tupleDesc;
 	slot->tts_mcxt = CurrentMemoryContext;
 	slot->tts_nvalid = 0;
+	slot->tts_nfixed = -1;
 
 	if (tupleDesc != NULL)
 	{
@@ -1499,6 +1613,7 @@ ExecSetSlotDescriptor(TupleTableSlot *slot, /* slot to change */
 	 * Install the new descriptor; if it's refcounted, bump its refcount.
 	 */
 	slot->tts_tupleDescriptor = tupdesc;
+	slot->tts_nfixed = -1;
 	PinTupleDesc(tupdesc);
 
 	/*
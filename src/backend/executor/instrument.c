@@ -14,16 +14,40 @@
 #include "postgres.h"
 
 #include <unistd.h>
+#ifdef HAVE_LINUX_PERF_EVENT_H
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
 
 #include "executor/instrument.h"
+#include "storage/fd.h"
 
 BufferUsage pgBufferUsage;
 static BufferUsage save_pgBufferUsage;
 WalUsage	pgWalUsage;
 static WalUsage save_pgWalUsage;
 
+/*
+ * Hardware performance counters, for INSTRUMENT_CPU.  They're opened on
+ * first use as one perf event group, so that all of them can be read with a
+ * single read() call, and stay open for the life of the process.  The cycle
+ * counter leads the group; any other counter the hardware doesn't provide is
+ * left out of the group and reads as zero.
+ */
+#define NUM_CPU_COUNTERS	4
+
+static int	cpu_counter_leader = -1;	/* group leader fd, or -1 */
+static bool cpu_counters_tried = false;
+static int	cpu_counters_open = 0;	/* number of events in the group */
+static int	cpu_counter_slot[NUM_CPU_COUNTERS];	/* position in group, or -1 */
+static CpuUsage cpu_usage_last;
+
 static void BufferUsageAdd(BufferUsage *dst, const BufferUsage *add);
 static void WalUsageAdd(WalUsage *dst, WalUsage *add);
+static void CpuUsageRead(CpuUsage *usage);
+static void CpuUsageAdd(CpuUsage *dst, const CpuUsage *add);
+static void CpuUsageAccumDiff(CpuUsage *dst, const CpuUsage *add,
+							  const CpuUsage *sub);
 
 
 /* Allocate new instrumentation structure(s) */
@@ -34,10 +58,12 @@ InstrAlloc(int n, int instrument_options, bool async_mode)
 
 	/* initialize all fields to zeroes, then modify as needed */
 	instr = palloc0(n * sizeof(Instrumentation));
-	if (instrument_options & (INSTRUMENT_BUFFERS | INSTRUMENT_TIMER | INSTRUMENT_WAL))
+	if (instrument_options & (INSTRUMENT_BUFFERS | INSTRUMENT_TIMER |
+							  INSTRUMENT_WAL | INSTRUMENT_CPU))
 	{
 		bool		need_buffers = (instrument_options & INSTRUMENT_BUFFERS) != 0;
 		bool		need_wal = (instrument_options & INSTRUMENT_WAL) != 0;
+		bool		need_cpu = (instrument_options & INSTRUMENT_CPU) != 0;
 		bool		need_timer = (instrument_options & INSTRUMENT_TIMER) != 0;
 		int			i;
 
@@ -45,6 +71,7 @@ InstrAlloc(int n, int instrument_options, bool async_mode)
 		{
 			instr[i].need_bufusage = need_buffers;
 			instr[i].need_walusage = need_wal;
+			instr[i].need_cpuusage = need_cpu;
 			instr[i].need_timer = need_timer;
 			instr[i].async_mode = async_mode;
 		}
@@ -60,6 +87,7 @@ InstrInit(Instrumentation *instr, int instrument_options)
 	memset(instr, 0, sizeof(Instrumentation));
 	instr->need_bufusage = (instrument_options & INSTRUMENT_BUFFERS) != 0;
 	instr->need_walusage = (instrument_options & INSTRUMENT_WAL) != 0;
+	instr->need_cpuusage = (instrument_options & INSTRUMENT_CPU) != 0;
 	instr->need_timer = (instrument_options & INSTRUMENT_TIMER) != 0;
 }
 
@@ -77,6 +105,9 @@ InstrStartNode(Instrumentation *instr)
 
 	if (instr->need_walusage)
 		instr->walusage_start = pgWalUsage;
+
+	if (instr->need_cpuusage)
+		CpuUsageRead(&instr->cpuusage_start);
 }
 
 /* Exit from a plan node */
@@ -110,6 +141,14 @@ InstrStopNode(Instrumentation *instr, double nTuples)
 		WalUsageAccumDiff(&instr->walusage,
 						  &pgWalUsage, &instr->walusage_start);
 
+	if (instr->need_cpuusage)
+	{
+		CpuUsage	cpuusage;
+
+		CpuUsageRead(&cpuusage);
+		CpuUsageAccumDiff(&instr->cpuusage, &cpuusage, &instr->cpuusage_start);
+	}
+
 	/* Is this the first tuple of this cycle? */
 	if (!instr->running)
 	{
@@ -193,6 +232,9 @@ InstrAggNode(Instrumentation *dst, Instrumentation *add)
 
 	if (dst->need_walusage)
 		WalUsageAdd(&dst->walusage, &add->walusage);
+
+	if (dst->need_cpuusage)
+		CpuUsageAdd(&dst->cpuusage, &add->cpuusage);
 }
 
 /* note current values during parallel executor startup */
@@ -291,3 +333,118 @@ WalUsageAccumDiff(WalUsage *dst, const WalUsage *add, const WalUsage *sub)
 	dst->wal_fpi += add->wal_fpi - sub->wal_fpi;
 	dst->wal_buffers_full += add->wal_buffers_full - sub->wal_buffers_full;
 }
+
+/*
+ * Open the hardware performance counters, if we haven't tried already, and
+ * report whether they can be used.  They can't if there's no kernel support,
+ * perf_event_paranoid forbids it, or there isn't even a cycle counter; other
+ * missing counters just read as zero.  Callers must check this before asking
+ * for INSTRUMENT_CPU: EXPLAIN refuses the CPU option, and parallel workers
+ * raise an error, rather than silently count zeroes.
+ */
+bool
+InstrCpuUsageAvailable(void)
+{
+#ifdef HAVE_LINUX_PERF_EVENT_H
+	static const uint64 configs[NUM_CPU_COUNTERS] = {
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_MISSES
+	};
+
+	if (cpu_counters_tried)
+		return cpu_counter_leader >= 0;
+	cpu_counters_tried = true;
+
+	for (int i = 0; i < NUM_CPU_COUNTERS; i++)
+	{
+		struct perf_event_attr attr;
+		int			fd;
+
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = configs[i];
+		attr.read_format = PERF_FORMAT_GROUP;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		fd = syscall(__NR_perf_event_open, &attr, 0, -1,
+					 cpu_counter_leader, PERF_FLAG_FD_CLOEXEC);
+		if (fd < 0)
+		{
+			if (i == 0)
+				return false;
+			cpu_counter_slot[i] = -1;
+			continue;
+		}
+
+		/* The member fds must stay open too, else their events go away */
+		ReserveExternalFD();
+		if (i == 0)
+			cpu_counter_leader = fd;
+		cpu_counter_slot[i] = cpu_counters_open++;
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+/*
+ * Read the current counter values.  If the counters are unavailable, or the
+ * read fails, return the last values read so that deltas come out as zero.
+ */
+static void
+CpuUsageRead(CpuUsage *usage)
+{
+#ifdef HAVE_LINUX_PERF_EVENT_H
+	struct
+	{
+		uint64		nr;
+		uint64		values[NUM_CPU_COUNTERS];
+	}			buf;
+
+	if (InstrCpuUsageAvailable())
+	{
+		ssize_t		len = sizeof(uint64) * (1 + cpu_counters_open);
+
+		if (read(cpu_counter_leader, &buf, len) == len &&
+			buf.nr == cpu_counters_open)
+		{
+#define CPU_COUNTER_VALUE(i) \
+	(cpu_counter_slot[i] >= 0 ? buf.values[cpu_counter_slot[i]] : 0)
+
+			cpu_usage_last.cycles = CPU_COUNTER_VALUE(0);
+			cpu_usage_last.instructions = CPU_COUNTER_VALUE(1);
+			cpu_usage_last.cache_misses = CPU_COUNTER_VALUE(2);
+			cpu_usage_last.branch_misses = CPU_COUNTER_VALUE(3);
+#undef CPU_COUNTER_VALUE
+		}
+	}
+#endif
+
+	*usage = cpu_usage_last;
+}
+
+/* dst += add */
+static void
+CpuUsageAdd(CpuUsage *dst, const CpuUsage *add)
+{
+	dst->cycles += add->cycles;
+	dst->instructions += add->instructions;
+	dst->cache_misses += add->cache_misses;
+	dst->branch_misses += add->branch_misses;
+}
+
+/* dst += add - sub */
+static void
+CpuUsageAccumDiff(CpuUsage *dst, const CpuUsage *add, const CpuUsage *sub)
+{
+	dst->cycles += add->cycles - sub->cycles;
+	dst->instructions += add->instructions - sub->instructions;
+	dst->cache_misses += add->cache_misses - sub->cache_misses;
+	dst->branch_misses += add->branch_misses - sub->branch_misses;
+}
@@ -226,6 +226,13 @@
  *	  imposing a limit on the number of groups separately from the amount of
  *	  memory consumed.
  *
+ *	  A partial aggregate (one whose output goes to a Finalize Aggregate)
+ *	  usually does not spill at all: when it hits the limit it emits the
+ *	  groups it has so far, empties the hash table and carries on reading its
+ *	  input.  The finalize step combines the duplicate groups this produces.
+ *	  If the hash table holds too few groups to make that worthwhile, it
+ *	  spills as usual instead, and doesn't flush again after that.
+ *
  *    Transition / Combine function invocation:
  *
  *    For performance reasons transition functions, including combine
@@ -315,6 +322,14 @@
  */
 #define HASHAGG_HLL_BIT_WIDTH 5
 
+/*
+ * A partial aggregate only flushes its hash table, rather than spilling, if
+ * the table holds at least this many groups.  Fewer groups mean that each
+ * one's transition state is large, so flushing would send the same groups to
+ * the Finalize Aggregate over and over while barely reducing the input.
+ */
+#define HASHAGG_FLUSH_MIN_GROUPS 256
+
 /*
  * Assume the palloc overhead always uses sizeof(MemoryChunk) bytes.
  */
@@ -420,6 +435,7 @@ static void lookup_hash_entries(AggState *aggstate);
 static TupleTableSlot *agg_retrieve_direct(AggState *aggstate);
 static void agg_fill_hash_table(AggState *aggstate);
 static bool agg_refill_hash_table(AggState *aggstate);
+static void hashagg_flush_partial(AggState *aggstate);
 static TupleTableSlot *agg_retrieve_hash_table(AggState *aggstate);
 static TupleTableSlot *agg_retrieve_hash_table_in_memory(AggState *aggstate);
 static void hash_agg_check_limits(AggState *aggstate);
@@ -1860,7 +1876,8 @@ hash_agg_set_limits(double hashentrysize, double input_groups, int used_bits,
  * hash_agg_check_limits
  *
  * After adding a new group to the hash table, check whether we need to enter
- * spill mode. Allocations may happen without adding new groups (for instance,
+ * spill mode, or flush the hash table if we're computing partial aggregates
+ * and it holds enough groups. Allocations may happen without adding new groups (for instance,
  * if the transition state size grows), so this check is imperfect.
  */
 static void
@@ -1899,7 +1916,14 @@ hash_agg_check_limits(AggState *aggstate)
 	}
 
 	if (do_spill)
-		hash_agg_enter_spill_mode(aggstate);
+	{
+		if (aggstate->hash_partial_flush &&
+			!aggstate->hash_ever_spilled &&
+			ngroups >= HASHAGG_FLUSH_MIN_GROUPS)
+			aggstate->hash_flush_pending = true;
+		else
+			hash_agg_enter_spill_mode(aggstate);
+	}
 }
 
 /*
@@ -2652,10 +2676,22 @@ agg_fill_hash_table(AggState *aggstate)
 		 * hash lookups do this too
 		 */
 		ResetExprContext(aggstate->tmpcontext);
+
+		/*
+		 * If we're only computing partial aggregates and the hash table is
+		 * full, stop here and emit what we have; see hashagg_flush_partial().
+		 */
+		if (aggstate->hash_flush_pending)
+			break;
 	}
 
-	/* finalize spills, if any */
-	hashagg_finish_initial_spills(aggstate);
+	if (aggstate->hash_flush_pending)
+		hash_agg_update_metrics(aggstate, false, 0);
+	else
+	{
+		/* finalize spills, if any */
+		hashagg_finish_initial_spills(aggstate);
+	}
 
 	aggstate->table_filled = true;
 	/* Initialize to walk the first hash table */
@@ -2841,6 +2877,11 @@ agg_retrieve_hash_table(AggState *aggstate)
 		result = agg_retrieve_hash_table_in_memory(aggstate);
 		if (result == NULL)
 		{
+			if (aggstate->hash_flush_pending)
+			{
+				hashagg_flush_partial(aggstate);
+				continue;
+			}
 			if (!agg_refill_hash_table(aggstate))
 			{
 				aggstate->agg_done = true;
@@ -2852,6 +2893,42 @@ agg_retrieve_hash_table(AggState *aggstate)
 	return result;
 }
 
+/*
+ * hashagg_flush_partial
+ *
+ * When an Agg node only computes partial aggregates, nothing requires that
+ * each group be emitted exactly once: the Finalize Aggregate above us
+ * combines whatever partial states it receives for a group.  So, instead of
+ * spilling input tuples to disk once the hash table reaches its memory
+ * limit, agg_fill_hash_table() stops early and the groups aggregated so far
+ * are emitted.  Once they have all been returned, we come here to throw the
+ * hash table away and resume reading the outer plan into an empty one.
+ *
+ * This keeps each worker of a parallel aggregate within hash_mem and avoids
+ * writing and rereading its input, at the price of sending some groups up to
+ * the leader more than once.
+ */
+static void
+hashagg_flush_partial(AggState *aggstate)
+{
+	Assert(aggstate->hash_partial_flush);
+	Assert(aggstate->hash_flush_pending);
+
+	aggstate->hash_flush_pending = false;
+	aggstate->hash_ever_flushed = true;
+	aggstate->hash_flushes++;
+
+	/* free memory and reset hash tables */
+	ReScanExprContext(aggstate->hashcontext);
+	MemoryContextReset(aggstate->hash_tablecxt);
+	for (int setno = 0; setno < aggstate->num_hashes; setno++)
+		ResetTupleHashTable(aggstate->perhash[setno].hashtable);
+
+	aggstate->hash_ngroups_current = 0;
+
+	agg_fill_hash_table(aggstate);
+}
+
 /*
  * Retrieve the groups from the in-memory hash tables without considering any
  * spilled tuples.
@@ -3725,6 +3802,15 @@ ExecInitAgg(Agg *node, EState *estate, int eflags)
 
 		/* Initialize this to 1, meaning nothing spilled, yet */
 		aggstate->hash_batches_used = 1;
+
+		/*
+		 * A partial aggregate without grouping sets can emit its groups and
+		 * start over when it runs out of memory, rather than spilling.
+		 */
+		aggstate->hash_partial_flush =
+			(aggstate->aggstrategy == AGG_HASHED &&
+			 aggstate->num_hashes == 1 &&
+			 DO_AGGSPLIT_SKIPFINAL(aggstate->aggsplit));
 	}
 
 	/*
@@ -4416,6 +4502,7 @@ ExecEndAgg(AggState *node)
 		Assert(ParallelWorkerNumber <= node->shared_info->num_workers);
 		si = &node->shared_info->sinstrument[ParallelWorkerNumber];
 		si->hash_batches_used = node->hash_batches_used;
+		si->hash_flushes = node->hash_flushes;
 		si->hash_disk_used = node->hash_disk_used;
 		si->hash_mem_peak = node->hash_mem_peak;
 	}
@@ -4493,6 +4580,7 @@ ExecReScanAgg(AggState *node)
 		 * again.
 		 */
 		if (outerPlan->chgParam == NULL && !node->hash_ever_spilled &&
+			!node->hash_ever_flushed &&
 			!bms_overlap(node->ss.ps.chgParam, aggnode->aggParams))
 		{
 			ResetTupleHashIterator(node->perhash[0].hashtable,
@@ -4553,6 +4641,8 @@ ExecReScanAgg(AggState *node)
 
 		node->hash_ever_spilled = false;
 		node->hash_spill_mode = false;
+		node->hash_flush_pending = false;
+		node->hash_ever_flushed = false;
 		node->hash_ngroups_current = 0;
 
 		ReScanExprContext(node->hashcontext);
@@ -2598,6 +2598,14 @@ llvm_compile_expr(ExprState *state)
 			case EEOP_AGG_PLAIN_TRANS_INIT_STRICT_BYREF:
 			case EEOP_AGG_PLAIN_TRANS_STRICT_BYREF:
 			case EEOP_AGG_PLAIN_TRANS_BYREF:
+
+				/*
+				 * The inlined count() and sum(int4) steps are just calls of
+				 * the (strict resp. non-strict) by-value transition
+				 * function, as far as JIT compilation is concerned.
+				 */
+			case EEOP_AGG_PLAIN_TRANS_INT8INC:
+			case EEOP_AGG_PLAIN_TRANS_INT4_SUM:
 				{
 					AggState   *aggstate;
 					AggStatePerTrans pertrans;
@@ -2713,7 +2721,8 @@ llvm_compile_expr(ExprState *state)
 					if (opcode == EEOP_AGG_PLAIN_TRANS_INIT_STRICT_BYVAL ||
 						opcode == EEOP_AGG_PLAIN_TRANS_INIT_STRICT_BYREF ||
 						opcode == EEOP_AGG_PLAIN_TRANS_STRICT_BYVAL ||
-						opcode == EEOP_AGG_PLAIN_TRANS_STRICT_BYREF)
+						opcode == EEOP_AGG_PLAIN_TRANS_STRICT_BYREF ||
+						opcode == EEOP_AGG_PLAIN_TRANS_INT8INC)
 					{
 						LLVMValueRef v_transnull;
 						LLVMBasicBlockRef b_strictpass;
@@ -112,12 +112,16 @@ static List *sock_paths = NIL;
 /*
  * Buffers for low-level I/O.
  *
- * The receive buffer is fixed size. Send buffer is usually 8k, but can be
+ * The receive buffer is fixed size. Send buffer is usually 32k, but can be
  * enlarged by pq_putmessage_noblock() if the message doesn't fit otherwise.
+ *
+ * Both are sized so that a pipelining client's stream of small messages,
+ * and the equally small responses to them, move in a few large socket
+ * reads and writes rather than one system call per few messages.
  */
 
-#define PQ_SEND_BUFFER_SIZE 8192
-#define PQ_RECV_BUFFER_SIZE 8192
+#define PQ_SEND_BUFFER_SIZE 32768
+#define PQ_RECV_BUFFER_SIZE 32768
 
 static char *PqSendBuffer;
 static int	PqSendBufferSize;	/* Size send buffer */
@@ -228,8 +232,7 @@ pq_init(ClientSocket *client_sock)
 		 * performance suffers.  The Postgres send buffer can be enlarged if a
 		 * very large message needs to be sent, but we won't attempt to
 		 * enlarge the OS buffer if that happens, so somewhat arbitrarily
-		 * ensure that the OS buffer is at least PQ_SEND_BUFFER_SIZE * 4.
-		 * (That's 32kB with the current default).
+		 * ensure that the OS buffer is at least 32kB.
 		 *
 		 * The default OS buffer size used to be 8kB in earlier Windows
 		 * versions, but was raised to 64kB in Windows 2012.  So it shouldn't
@@ -250,7 +253,7 @@ pq_init(ClientSocket *client_sock)
 			ereport(FATAL,
 					(errmsg("%s(%s) failed: %m", "getsockopt", "SO_SNDBUF")));
 		}
-		newopt = PQ_SEND_BUFFER_SIZE * 4;
+		newopt = 32768;
 		if (oldopt < newopt)
 		{
 			if (setsockopt(port->sock, SOL_SOCKET, SO_SNDBUF, (char *) &newopt,
@@ -127,6 +127,7 @@ int			autovacuum_vac_ins_thresh;
 double		autovacuum_vac_ins_scale;
 int			autovacuum_anl_thresh;
 double		autovacuum_anl_scale;
+double		autovacuum_freeze_debt_scale = -1;
 int			autovacuum_freeze_max_age;
 int			autovacuum_multixact_freeze_max_age;
 
@@ -139,6 +140,12 @@ int			Log_autovacuum_min_duration = 600000;
 #define MIN_AUTOVAC_SLEEPTIME 100.0 /* milliseconds */
 #define MAX_AUTOVAC_SLEEPTIME 300	/* seconds */
 
+/*
+ * After an autovacuum that froze no pages, wait this many naptimes before
+ * letting the freeze debt trigger fire again for the same table.
+ */
+#define FREEZE_DEBT_RETRY_NAPTIMES	10
+
 /*
  * Variables to save the cost-related storage parameters for the current
  * relation being vacuumed by this autovacuum worker. Using these, we can
@@ -2650,6 +2657,10 @@ perform_work_item(AutoVacuumWorkItem *workitem)
 									ObjectIdGetDatum(workitem->avw_relation),
 									Int64GetDatum((int64) workitem->avw_blockNumber));
 				break;
+			case AVW_GINCleanPendingList:
+				DirectFunctionCall1(gin_clean_pending_list,
+									ObjectIdGetDatum(workitem->avw_relation));
+				break;
 			default:
 				elog(WARNING, "unrecognized work item found: type %d",
 					 workitem->avw_type);
@@ -2994,6 +3005,7 @@ relation_needs_vacanalyze(Oid relid,
 				anltuples;
 
 	/* freeze parameters */
+	int			freeze_min_age;
 	int			freeze_max_age;
 	int			multixact_freeze_max_age;
 	TransactionId xidForceLimit;
@@ -3040,6 +3052,10 @@ relation_needs_vacanalyze(Oid relid,
 		? relopts->analyze_threshold
 		: autovacuum_anl_thresh;
 
+	freeze_min_age = (relopts && relopts->freeze_min_age >= 0)
+		? relopts->freeze_min_age
+		: vacuum_freeze_min_age;
+
 	freeze_max_age = (relopts && relopts->freeze_max_age >= 0)
 		? Min(relopts->freeze_max_age, autovacuum_freeze_max_age)
 		: autovacuum_freeze_max_age;
@@ -3090,6 +3106,7 @@ relation_needs_vacanalyze(Oid relid,
 		float4		reltuples = classForm->reltuples;
 		int32		relpages = classForm->relpages;
 		int32		relallfrozen = classForm->relallfrozen;
+		bool		freeze_debt = false;
 
 		vactuples = tabentry->dead_tuples;
 		instuples = tabentry->ins_since_vacuum;
@@ -3116,6 +3133,47 @@ relation_needs_vacanalyze(Oid relid,
 			pcnt_unfrozen = 1 - ((float4) relallfrozen / relpages);
 		}
 
+		/*
+		 * Pages that are all-visible but not all-frozen are "freeze debt":
+		 * sooner or later an aggressive vacuum will have to read and freeze
+		 * all of them at once.  If enough of the table is in that state,
+		 * vacuum it now.  A normal vacuum's eager scanning will then freeze
+		 * a capped share of those pages, so the debt is paid down in small
+		 * increments instead.
+		 *
+		 * Eager scanning only happens for tables of at least two eager scan
+		 * regions, and only once the table's relfrozenxid is older than the
+		 * freeze cutoff, so don't bother otherwise.  That cutoff is really
+		 * computed from OldestXmin, which a long-running snapshot can hold
+		 * back, so also back off for a while if the last autovacuum failed
+		 * to freeze any pages: vacuuming again right away would most likely
+		 * be just as futile.  Once FREEZE_DEBT_RETRY_NAPTIMES naptimes have
+		 * passed, the snapshot may well be gone, so try again.
+		 */
+		if (autovacuum_freeze_debt_scale >= 0 &&
+			relpages >= 2 * EAGER_SCAN_REGION_SIZE &&
+			TransactionIdIsNormal(relfrozenxid) &&
+			(tabentry->autovacuum_count == 0 ||
+			 tabentry->autovacuum_frozen_pages > 0 ||
+			 GetCurrentTimestamp() >=
+			 TimestampTzPlusSeconds(tabentry->last_autovacuum_time,
+									(int64) FREEZE_DEBT_RETRY_NAPTIMES *
+									autovacuum_naptime)))
+		{
+			int32		relallvisible = Min(classForm->relallvisible, relpages);
+			TransactionId xidFreezeLimit;
+
+			xidFreezeLimit = recentXid - freeze_min_age;
+			if (xidFreezeLimit < FirstNormalTransactionId)
+				xidFreezeLimit -= FirstNormalTransactionId;
+
+			if (relallvisible > relallfrozen &&
+				(float4) (relallvisible - relallfrozen) >
+				autovacuum_freeze_debt_scale * relpages &&
+				TransactionIdPrecedes(relfrozenxid, xidFreezeLimit))
+				freeze_debt = true;
+		}
+
 		vacthresh = (float4) vac_base_thresh + vac_scale_factor * reltuples;
 		if (vac_max_thresh >= 0 && vacthresh > (float4) vac_max_thresh)
 			vacthresh = (float4) vac_max_thresh;
@@ -3139,7 +3197,7 @@ relation_needs_vacanalyze(Oid relid,
 				 vactuples, vacthresh, anltuples, anlthresh);
 
 		/* Determine if this table needs vacuum or analyze. */
-		*dovacuum = force_vacuum || (vactuples > vacthresh) ||
+		*dovacuum = force_vacuum || freeze_debt || (vactuples > vacthresh) ||
 			(vac_ins_base_thresh >= 0 && instuples > vacinsthresh);
 		*doanalyze = (anltuples > anlthresh);
 	}
@@ -3255,6 +3313,10 @@ autovac_report_workitem(AutoVacuumWorkItem *workitem,
 			snprintf(activity, MAX_AUTOVAC_ACTIV_LEN,
 					 "autovacuum: BRIN summarize");
 			break;
+		case AVW_GINCleanPendingList:
+			snprintf(activity, MAX_AUTOVAC_ACTIV_LEN,
+					 "autovacuum: GIN pending list cleanup");
+			break;
 	}
 
 	/*
@@ -3292,6 +3354,9 @@ AutoVacuumingActive(void)
 /*
  * Request one work item to the next autovacuum run processing our database.
  * Return false if the request can't be recorded.
+ *
+ * If an identical request is already queued and not yet being worked on,
+ * it will take care of this one too, so we don't record another.
  */
 bool
 AutoVacuumRequestWork(AutoVacuumWorkItemType type, Oid relationId,
@@ -3302,6 +3367,21 @@ AutoVacuumRequestWork(AutoVacuumWorkItemType type, Oid relationId,
 
 	LWLockAcquire(AutovacuumLock, LW_EXCLUSIVE);
 
+	for (i = 0; i < NUM_WORKITEMS; i++)
+	{
+		AutoVacuumWorkItem *workitem = &AutoVacuumShmem->av_workItems[i];
+
+		if (workitem->avw_used && !workitem->avw_active &&
+			workitem->avw_type == type &&
+			workitem->avw_database == MyDatabaseId &&
+			workitem->avw_relation == relationId &&
+			workitem->avw_blockNumber == blkno)
+		{
+			LWLockRelease(AutovacuumLock);
+			return true;
+		}
+	}
+
 	/*
 	 * Locate an unused work item and fill it with the given data.
 	 */
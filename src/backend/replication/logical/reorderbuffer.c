@@ -225,6 +225,12 @@ typedef struct ReorderBufferDiskChange
 int			logical_decoding_work_mem;
 static const Size max_changes_in_memory = 4096; /* XXX for restore only */
 
+/*
+ * Serialized changes are collected in a buffer of this size and written out
+ * together, rather than issuing one write() call per change.
+ */
+#define SPILL_BUFFER_SIZE	(64 * 1024)
+
 /* GUC variable */
 int			debug_logical_replication_streaming = DEBUG_LOGICAL_REP_STREAMING_BUFFERED;
 
@@ -265,7 +271,12 @@ static void ReorderBufferExecuteInvalidations(uint32 nmsgs, SharedInvalidationMe
 static void ReorderBufferCheckMemoryLimit(ReorderBuffer *rb);
 static void ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn);
 static void ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
-										 int fd, ReorderBufferChange *change);
+										 int fd, StringInfo spillbuf,
+										 ReorderBufferChange *change);
+static void ReorderBufferSerializeFlush(ReorderBufferTXN *txn, int fd,
+										StringInfo spillbuf);
+static void ReorderBufferSerializeWrite(ReorderBufferTXN *txn, int fd,
+										const char *data, Size len);
 static Size ReorderBufferRestoreChanges(ReorderBuffer *rb, ReorderBufferTXN *txn,
 										TXNEntryFile *file, XLogSegNo *segno);
 static void ReorderBufferRestoreChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
@@ -3968,6 +3979,7 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 	XLogSegNo	curOpenSegNo = 0;
 	Size		spilled = 0;
 	Size		size = txn->size;
+	StringInfoData spillbuf;
 
 	elog(DEBUG2, "spill %u changes in XID %u to disk",
 		 (uint32) txn->nentries_mem, txn->xid);
@@ -3981,6 +3993,8 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 		ReorderBufferSerializeTXN(rb, subtxn);
 	}
 
+	initStringInfoExt(&spillbuf, SPILL_BUFFER_SIZE);
+
 	/* serialize changestream */
 	dlist_foreach_modify(change_i, &txn->changes)
 	{
@@ -3998,7 +4012,10 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 			char		path[MAXPGPATH];
 
 			if (fd != -1)
+			{
+				ReorderBufferSerializeFlush(txn, fd, &spillbuf);
 				CloseTransientFile(fd);
+			}
 
 			XLByteToSeg(change->lsn, curOpenSegNo, wal_segment_size);
 
@@ -4019,7 +4036,7 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 						 errmsg("could not open file \"%s\": %m", path)));
 		}
 
-		ReorderBufferSerializeChange(rb, txn, fd, change);
+		ReorderBufferSerializeChange(rb, txn, fd, &spillbuf, change);
 		dlist_delete(&change->node);
 		ReorderBufferFreeChange(rb, change, false);
 
@@ -4048,15 +4065,25 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 	txn->txn_flags |= RBTXN_IS_SERIALIZED;
 
 	if (fd != -1)
+	{
+		ReorderBufferSerializeFlush(txn, fd, &spillbuf);
 		CloseTransientFile(fd);
+	}
+
+	pfree(spillbuf.data);
 }
 
 /*
  * Serialize individual change to disk.
+ *
+ * The serialized change is appended to spillbuf, which is written out when
+ * it fills up; the caller must flush it before closing fd.  Changes too big
+ * to fit in spillbuf are written out directly instead.
  */
 static void
 ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
-							 int fd, ReorderBufferChange *change)
+							 int fd, StringInfo spillbuf,
+							 ReorderBufferChange *change)
 {
 	ReorderBufferDiskChange *ondisk;
 	Size		sz = sizeof(ReorderBufferDiskChange);
@@ -4237,9 +4264,56 @@ ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
 
 	ondisk->size = sz;
 
+	/*
+	 * Add the change to the spill buffer, flushing it first if there isn't
+	 * enough room.  A change that wouldn't fit even in an empty buffer is
+	 * written straight from rb->outbuf rather than copied.
+	 */
+	if (spillbuf->len + sz > SPILL_BUFFER_SIZE)
+		ReorderBufferSerializeFlush(txn, fd, spillbuf);
+	if (sz >= SPILL_BUFFER_SIZE)
+		ReorderBufferSerializeWrite(txn, fd, rb->outbuf, sz);
+	else
+		appendBinaryStringInfo(spillbuf, rb->outbuf, sz);
+
+	/*
+	 * Keep the transaction's final_lsn up to date with each change we send to
+	 * disk, so that ReorderBufferRestoreCleanup works correctly.  (We used to
+	 * only do this on commit and abort records, but that doesn't work if a
+	 * system crash leaves a transaction without its abort record).
+	 *
+	 * Make sure not to move it backwards.
+	 */
+	if (txn->final_lsn < change->lsn)
+		txn->final_lsn = change->lsn;
+
+	Assert(ondisk->change.action == change->action);
+}
+
+/*
+ * Write out the changes collected in spillbuf.
+ */
+static void
+ReorderBufferSerializeFlush(ReorderBufferTXN *txn, int fd, StringInfo spillbuf)
+{
+	if (spillbuf->len == 0)
+		return;
+
+	ReorderBufferSerializeWrite(txn, fd, spillbuf->data, spillbuf->len);
+
+	resetStringInfo(spillbuf);
+}
+
+/*
+ * Write serialized changes to the transaction's spill file.
+ */
+static void
+ReorderBufferSerializeWrite(ReorderBufferTXN *txn, int fd,
+							const char *data, Size len)
+{
 	errno = 0;
 	pgstat_report_wait_start(WAIT_EVENT_REORDER_BUFFER_WRITE);
-	if (write(fd, rb->outbuf, ondisk->size) != ondisk->size)
+	if (write(fd, data, len) != len)
 	{
 		int			save_errno = errno;
 
@@ -4253,19 +4327,6 @@ ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
 						txn->xid)));
 	}
 	pgstat_report_wait_end();
-
-	/*
-	 * Keep the transaction's final_lsn up to date with each change we send to
-	 * disk, so that ReorderBufferRestoreCleanup works correctly.  (We used to
-	 * only do this on commit and abort records, but that doesn't work if a
-	 * system crash leaves a transaction without its abort record).
-	 *
-	 * Make sure not to move it backwards.
-	 */
-	if (txn->final_lsn < change->lsn)
-		txn->final_lsn = change->lsn;
-
-	Assert(ondisk->change.action == change->action);
 }
 
 /* Returns true, if the output plugin supports streaming, false, otherwise. */
@@ -21,6 +21,7 @@
  */
 #include "postgres.h"
 
+#include "common/hashfn.h"
 #include "storage/buf_internals.h"
 
 /* entry for buffer lookup hashtable */
@@ -32,6 +33,52 @@ typedef struct
 
 static HTAB *SharedBufHash;
 
+static uint32 buftag_hash(const void *key, Size keysize);
+static int	buftag_match(const void *key1, const void *key2, Size keysize);
+
+
+/*
+ * Hash a BufferTag.
+ *
+ * Buffer lookups are frequent enough that hashing the tag with hash_bytes()
+ * through dynahash's function pointer shows up in profiles.  Instead, pack
+ * the five fields into two 64-bit words and mix them with the murmur
+ * finalizer, which is inlined into BufTableHashCode().  The low bits of the
+ * result pick both the mapping partition and the hash bucket, and are well
+ * distributed even for runs of consecutive block numbers.
+ */
+static inline uint32
+BufTableHashTag(const BufferTag *tag)
+{
+	uint64		rel_block;
+	uint64		db_spc_fork;
+
+	rel_block = ((uint64) tag->relNumber << 32) | tag->blockNum;
+	db_spc_fork = ((uint64) tag->dbOid << 32) |
+		(tag->spcOid ^ ((uint32) tag->forkNum << 28));
+
+	return (uint32) murmurhash64(rel_block ^ murmurhash64(db_spc_fork));
+}
+
+/* dynahash hash function for the mapping table; see BufTableHashTag */
+static uint32
+buftag_hash(const void *key, Size keysize)
+{
+	Assert(keysize == sizeof(BufferTag));
+
+	return BufTableHashTag((const BufferTag *) key);
+}
+
+/* dynahash key comparison function for the mapping table */
+static int
+buftag_match(const void *key1, const void *key2, Size keysize)
+{
+	Assert(keysize == sizeof(BufferTag));
+
+	return BufferTagsEqual((const BufferTag *) key1,
+						   (const BufferTag *) key2) ? 0 : 1;
+}
+
 
 /*
  * Estimate space needed for mapping hashtable
@@ -57,12 +104,15 @@ InitBufTable(int size)
 	/* BufferTag maps to Buffer */
 	info.keysize = sizeof(BufferTag);
 	info.entrysize = sizeof(BufferLookupEnt);
+	info.hash = buftag_hash;
+	info.match = buftag_match;
 	info.num_partitions = NUM_BUFFER_PARTITIONS;
 
 	SharedBufHash = ShmemInitHash("Shared Buffer Lookup Table",
 								  size, size,
 								  &info,
-								  HASH_ELEM | HASH_BLOBS | HASH_PARTITION);
+								  HASH_ELEM | HASH_FUNCTION | HASH_COMPARE |
+								  HASH_PARTITION);
 }
 
 /*
@@ -72,12 +122,12 @@ InitBufTable(int size)
  * This must be passed to the lookup/insert/delete routines along with the
  * tag.  We do it like this because the callers need to know the hash code
  * in order to determine which buffer partition to lock, and we don't want
- * to do the hash computation twice (hash_any is a bit slow).
+ * to do the hash computation twice.
  */
 uint32
 BufTableHashCode(BufferTag *tagPtr)
 {
-	return get_hash_value(SharedBufHash, tagPtr);
+	return BufTableHashTag(tagPtr);
 }
 
 /*
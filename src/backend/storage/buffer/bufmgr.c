@@ -62,6 +62,7 @@
 #include "storage/smgr.h"
 #include "storage/standby.h"
 #include "utils/memdebug.h"
+#include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/rel.h"
 #include "utils/resowner.h"
@@ -140,6 +141,24 @@ typedef struct SMgrSortArray
 	SMgrRelation srel;
 } SMgrSortArray;
 
+/*
+ * State saved between calls of BgBufferSyncPartition(), so we can determine
+ * the strategy point's advance rate and avoid scanning already-cleaned
+ * buffers.  There's one of these for each clock-sweep partition.
+ */
+typedef struct BgBufferSyncState
+{
+	bool		saved_info_valid;
+	int			prev_strategy_buf_id;
+	uint32		prev_strategy_passes;
+	int			next_to_clean;
+	uint32		next_passes;
+
+	/* Moving averages of allocation rate and clean-buffer density */
+	float		smoothed_alloc;
+	float		smoothed_density;
+} BgBufferSyncState;
+
 /* GUC variables */
 bool		zero_damaged_pages = false;
 int			bgwriter_lru_maxpages = 100;
@@ -518,8 +537,13 @@ static void UnpinBuffer(BufferDesc *buf);
 static void UnpinBufferNoOwner(BufferDesc *buf);
 static void BufferSync(int flags);
 static uint32 WaitBufHdrUnlocked(BufferDesc *buf);
+static bool BgBufferSyncPartition(int partition, BgBufferSyncState *state,
+								  int max_pages, WritebackContext *wb_context);
 static int	SyncOneBuffer(int buf_id, bool skip_recently_used,
 						  WritebackContext *wb_context);
+static int	SyncBufferRun(CkptSortItem *items, int nitems, int max_combine,
+						  char *copy_space, WritebackContext *wb_context,
+						  int *nwritten);
 static void WaitIO(BufferDesc *buf);
 static void AbortBufferIO(Buffer buffer);
 static void shared_buffer_write_error_callback(void *arg);
@@ -3360,6 +3384,8 @@ BufferSync(int flags)
 	int			i;
 	int			mask = BM_DIRTY;
 	WritebackContext wb_context;
+	int			max_combine;
+	char	   *copy_space = NULL;
 
 	/*
 	 * Unless this is a shutdown checkpoint or we have been explicitly told,
@@ -3423,6 +3449,18 @@ BufferSync(int flags)
 
 	WritebackContextInit(&wb_context, &checkpoint_flush_after);
 
+	/*
+	 * Runs of buffers holding consecutive blocks are written with a single
+	 * vectored write, up to io_combine_limit blocks.  Remember the limit now,
+	 * since a configuration reload in CheckpointWriteDelay could change it.
+	 * With checksums enabled the pages have to be copied before being
+	 * checksummed, so we need workspace for a whole run.
+	 */
+	max_combine = io_combine_limit;
+	if (max_combine > 1 && DataChecksumsEnabled())
+		copy_space = palloc_aligned((Size) max_combine * BLCKSZ,
+									PG_IO_ALIGN_SIZE, 0);
+
 	TRACE_POSTGRESQL_BUFFER_SYNC_START(NBuffers, num_to_scan);
 
 	/*
@@ -3534,14 +3572,13 @@ BufferSync(int flags)
 		BufferDesc *bufHdr = NULL;
 		CkptTsStatus *ts_stat = (CkptTsStatus *)
 			DatumGetPointer(binaryheap_first(ts_heap));
+		int			nitems = 1;
 
 		buf_id = CkptBufferIds[ts_stat->index].buf_id;
 		Assert(buf_id != -1);
 
 		bufHdr = GetBufferDescriptor(buf_id);
 
-		num_processed++;
-
 		/*
 		 * We don't need to acquire the lock here, because we're only looking
 		 * at a single bit. It's possible that someone else writes the buffer
@@ -3556,7 +3593,25 @@ BufferSync(int flags)
 		 */
 		if (pg_atomic_read_u32(&bufHdr->state) & BM_CHECKPOINT_NEEDED)
 		{
-			if (SyncOneBuffer(buf_id, false, &wb_context) & BUF_WRITTEN)
+			CkptSortItem *item = &CkptBufferIds[ts_stat->index];
+			int			nleft = ts_stat->num_to_scan - ts_stat->num_scanned;
+
+			if (max_combine > 1 && nleft > 1 &&
+				item[1].relNumber == item[0].relNumber &&
+				item[1].forkNum == item[0].forkNum &&
+				item[1].blockNum == item[0].blockNum + 1)
+			{
+				int			nbufs;
+
+				nitems = SyncBufferRun(item, Min(nleft, max_combine),
+									   max_combine, copy_space,
+									   &wb_context, &nbufs);
+				for (i = 0; i < nbufs; i++)
+					TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(item[i].buf_id);
+				PendingCheckpointerStats.buffers_written += nbufs;
+				num_written += nbufs;
+			}
+			else if (SyncOneBuffer(buf_id, false, &wb_context) & BUF_WRITTEN)
 			{
 				TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(buf_id);
 				PendingCheckpointerStats.buffers_written++;
@@ -3568,9 +3623,10 @@ BufferSync(int flags)
 		 * Measure progress independent of actually having to flush the buffer
 		 * - otherwise writing become unbalanced.
 		 */
-		ts_stat->progress += ts_stat->progress_slice;
-		ts_stat->num_scanned++;
-		ts_stat->index++;
+		num_processed += nitems;
+		ts_stat->progress += ts_stat->progress_slice * nitems;
+		ts_stat->num_scanned += nitems;
+		ts_stat->index += nitems;
 
 		/* Have all the buffers from the tablespace been processed? */
 		if (ts_stat->num_scanned == ts_stat->num_to_scan)
@@ -3600,6 +3656,8 @@ BufferSync(int flags)
 	pfree(per_ts_stat);
 	per_ts_stat = NULL;
 	binaryheap_free(ts_heap);
+	if (copy_space)
+		pfree(copy_space);
 
 	/*
 	 * Update checkpoint statistics. As noted above, this doesn't include
@@ -3620,28 +3678,73 @@ BufferSync(int flags)
  * has been "lapped" and no buffer allocations have occurred recently,
  * or if the bgwriter has been effectively disabled by setting
  * bgwriter_lru_maxpages to 0.)
+ *
+ * Each clock-sweep partition is processed independently, and gets a share of
+ * bgwriter_lru_maxpages proportional to its size.  The shares are rounded
+ * down, and the pages left over are handed out one each to partitions in
+ * round-robin order, so that a round never writes more than
+ * bgwriter_lru_maxpages in total.
  */
 bool
 BgBufferSync(WritebackContext *wb_context)
+{
+	static BgBufferSyncState *states = NULL;
+	static int	next_extra_partition = 0;
+	int			npartitions = StrategyNumPartitions();
+	int			max_pages[MAX_CLOCK_SWEEP_PARTITIONS];
+	int			total_pages = Max(bgwriter_lru_maxpages, 0);
+	int			leftover = total_pages;
+	bool		hibernate = true;
+
+	if (states == NULL)
+	{
+		states = MemoryContextAllocZero(TopMemoryContext,
+										npartitions * sizeof(BgBufferSyncState));
+		for (int i = 0; i < npartitions; i++)
+			states[i].smoothed_density = 10.0;
+	}
+
+	Assert(npartitions <= MAX_CLOCK_SWEEP_PARTITIONS);
+	for (int i = 0; i < npartitions; i++)
+	{
+		int			first_buffer;
+		int			nbuffers;
+
+		StrategyPartitionRange(i, &first_buffer, &nbuffers);
+		max_pages[i] = (int64) total_pages * nbuffers / NBuffers;
+		leftover -= max_pages[i];
+	}
+	for (int i = 0; i < leftover; i++)
+		max_pages[(next_extra_partition + i) % npartitions]++;
+	next_extra_partition = (next_extra_partition + leftover) % npartitions;
+
+	for (int i = 0; i < npartitions; i++)
+	{
+		if (!BgBufferSyncPartition(i, &states[i], max_pages[i], wb_context))
+			hibernate = false;
+	}
+
+	return hibernate;
+}
+
+/*
+ * BgBufferSyncPartition -- BgBufferSync() work for one clock-sweep partition
+ *
+ * At most max_pages buffers are written.  Returns true if it's appropriate
+ * for the bgwriter to hibernate, as far as this partition is concerned.
+ */
+static bool
+BgBufferSyncPartition(int partition, BgBufferSyncState *state, int max_pages,
+					  WritebackContext *wb_context)
 {
 	/* info obtained from freelist.c */
 	int			strategy_buf_id;
 	uint32		strategy_passes;
 	uint32		recent_alloc;
 
-	/*
-	 * Information saved between calls so we can determine the strategy
-	 * point's advance rate and avoid scanning already-cleaned buffers.
-	 */
-	static bool saved_info_valid = false;
-	static int	prev_strategy_buf_id;
-	static uint32 prev_strategy_passes;
-	static int	next_to_clean;
-	static uint32 next_passes;
-
-	/* Moving averages of allocation rate and clean-buffer density */
-	static float smoothed_alloc = 0;
-	static float smoothed_density = 10.0;
+	/* range of buffers in this partition */
+	int			first_buffer;
+	int			nbuffers;
 
 	/* Potentially these could be tunables, but for now, not */
 	float		smoothing_samples = 16;
@@ -3669,7 +3772,9 @@ BgBufferSync(WritebackContext *wb_context)
 	 * Find out where the freelist clock sweep currently is, and how many
 	 * buffer allocations have happened since our last call.
 	 */
-	strategy_buf_id = StrategySyncStart(&strategy_passes, &recent_alloc);
+	StrategyPartitionRange(partition, &first_buffer, &nbuffers);
+	strategy_buf_id = StrategySyncStart(partition, &strategy_passes,
+										&recent_alloc) - first_buffer;
 
 	/* Report buffer alloc counts to pgstat */
 	PendingBgWriterStats.buf_alloc += recent_alloc;
@@ -3681,7 +3786,7 @@ BgBufferSync(WritebackContext *wb_context)
 	 */
 	if (bgwriter_lru_maxpages <= 0)
 	{
-		saved_info_valid = false;
+		state->saved_info_valid = false;
 		return true;
 	}
 
@@ -3693,34 +3798,34 @@ BgBufferSync(WritebackContext *wb_context)
 	 * weird-looking coding of xxx_passes comparisons are to avoid bogus
 	 * behavior when the passes counts wrap around.
 	 */
-	if (saved_info_valid)
+	if (state->saved_info_valid)
 	{
-		int32		passes_delta = strategy_passes - prev_strategy_passes;
+		int32		passes_delta = strategy_passes - state->prev_strategy_passes;
 
-		strategy_delta = strategy_buf_id - prev_strategy_buf_id;
-		strategy_delta += (long) passes_delta * NBuffers;
+		strategy_delta = strategy_buf_id - state->prev_strategy_buf_id;
+		strategy_delta += (long) passes_delta * nbuffers;
 
 		Assert(strategy_delta >= 0);
 
-		if ((int32) (next_passes - strategy_passes) > 0)
+		if ((int32) (state->next_passes - strategy_passes) > 0)
 		{
 			/* we're one pass ahead of the strategy point */
-			bufs_to_lap = strategy_buf_id - next_to_clean;
+			bufs_to_lap = strategy_buf_id - state->next_to_clean;
 #ifdef BGW_DEBUG
 			elog(DEBUG2, "bgwriter ahead: bgw %u-%u strategy %u-%u delta=%ld lap=%d",
-				 next_passes, next_to_clean,
+				 state->next_passes, state->next_to_clean,
 				 strategy_passes, strategy_buf_id,
 				 strategy_delta, bufs_to_lap);
 #endif
 		}
-		else if (next_passes == strategy_passes &&
-				 next_to_clean >= strategy_buf_id)
+		else if (state->next_passes == strategy_passes &&
+				 state->next_to_clean >= strategy_buf_id)
 		{
 			/* on same pass, but ahead or at least not behind */
-			bufs_to_lap = NBuffers - (next_to_clean - strategy_buf_id);
+			bufs_to_lap = nbuffers - (state->next_to_clean - strategy_buf_id);
 #ifdef BGW_DEBUG
 			elog(DEBUG2, "bgwriter ahead: bgw %u-%u strategy %u-%u delta=%ld lap=%d",
-				 next_passes, next_to_clean,
+				 state->next_passes, state->next_to_clean,
 				 strategy_passes, strategy_buf_id,
 				 strategy_delta, bufs_to_lap);
 #endif
@@ -3733,13 +3838,13 @@ BgBufferSync(WritebackContext *wb_context)
 			 */
 #ifdef BGW_DEBUG
 			elog(DEBUG2, "bgwriter behind: bgw %u-%u strategy %u-%u delta=%ld",
-				 next_passes, next_to_clean,
+				 state->next_passes, state->next_to_clean,
 				 strategy_passes, strategy_buf_id,
 				 strategy_delta);
 #endif
-			next_to_clean = strategy_buf_id;
-			next_passes = strategy_passes;
-			bufs_to_lap = NBuffers;
+			state->next_to_clean = strategy_buf_id;
+			state->next_passes = strategy_passes;
+			bufs_to_lap = nbuffers;
 		}
 	}
 	else
@@ -3753,15 +3858,15 @@ BgBufferSync(WritebackContext *wb_context)
 			 strategy_passes, strategy_buf_id);
 #endif
 		strategy_delta = 0;
-		next_to_clean = strategy_buf_id;
-		next_passes = strategy_passes;
-		bufs_to_lap = NBuffers;
+		state->next_to_clean = strategy_buf_id;
+		state->next_passes = strategy_passes;
+		bufs_to_lap = nbuffers;
 	}
 
 	/* Update saved info for next time */
-	prev_strategy_buf_id = strategy_buf_id;
-	prev_strategy_passes = strategy_passes;
-	saved_info_valid = true;
+	state->prev_strategy_buf_id = strategy_buf_id;
+	state->prev_strategy_passes = strategy_passes;
+	state->saved_info_valid = true;
 
 	/*
 	 * Compute how many buffers had to be scanned for each new allocation, ie,
@@ -3772,7 +3877,7 @@ BgBufferSync(WritebackContext *wb_context)
 	if (strategy_delta > 0 && recent_alloc > 0)
 	{
 		scans_per_alloc = (float) strategy_delta / (float) recent_alloc;
-		smoothed_density += (scans_per_alloc - smoothed_density) /
+		state->smoothed_density += (scans_per_alloc - state->smoothed_density) /
 			smoothing_samples;
 	}
 
@@ -3781,22 +3886,22 @@ BgBufferSync(WritebackContext *wb_context)
 	 * strategy point and where we've scanned ahead to, based on the smoothed
 	 * density estimate.
 	 */
-	bufs_ahead = NBuffers - bufs_to_lap;
-	reusable_buffers_est = (float) bufs_ahead / smoothed_density;
+	bufs_ahead = nbuffers - bufs_to_lap;
+	reusable_buffers_est = (float) bufs_ahead / state->smoothed_density;
 
 	/*
 	 * Track a moving average of recent buffer allocations.  Here, rather than
 	 * a true average we want a fast-attack, slow-decline behavior: we
 	 * immediately follow any increase.
 	 */
-	if (smoothed_alloc <= (float) recent_alloc)
-		smoothed_alloc = recent_alloc;
+	if (state->smoothed_alloc <= (float) recent_alloc)
+		state->smoothed_alloc = recent_alloc;
 	else
-		smoothed_alloc += ((float) recent_alloc - smoothed_alloc) /
+		state->smoothed_alloc += ((float) recent_alloc - state->smoothed_alloc) /
 			smoothing_samples;
 
 	/* Scale the estimate by a GUC to allow more aggressive tuning. */
-	upcoming_alloc_est = (int) (smoothed_alloc * bgwriter_lru_multiplier);
+	upcoming_alloc_est = (int) (state->smoothed_alloc * bgwriter_lru_multiplier);
 
 	/*
 	 * If recent_alloc remains at zero for many cycles, smoothed_alloc will
@@ -3807,7 +3912,7 @@ BgBufferSync(WritebackContext *wb_context)
 	 * syndrome.  It will pop back up as soon as recent_alloc increases.
 	 */
 	if (upcoming_alloc_est == 0)
-		smoothed_alloc = 0;
+		state->smoothed_alloc = 0;
 
 	/*
 	 * Even in cases where there's been little or no buffer allocation
@@ -3817,9 +3922,9 @@ BgBufferSync(WritebackContext *wb_context)
 	 *
 	 * (scan_whole_pool_milliseconds / BgWriterDelay) computes how many times
 	 * the BGW will be called during the scan_whole_pool time; slice the
-	 * buffer pool into that many sections.
+	 * partition into that many sections.
 	 */
-	min_scan_buffers = (int) (NBuffers / (scan_whole_pool_milliseconds / BgWriterDelay));
+	min_scan_buffers = (int) (nbuffers / (scan_whole_pool_milliseconds / BgWriterDelay));
 
 	if (upcoming_alloc_est < (min_scan_buffers + reusable_buffers_est))
 	{
@@ -3842,22 +3947,23 @@ BgBufferSync(WritebackContext *wb_context)
 	reusable_buffers = reusable_buffers_est;
 
 	/* Execute the LRU scan */
-	while (num_to_scan > 0 && reusable_buffers < upcoming_alloc_est)
+	while (num_to_scan > 0 && reusable_buffers < upcoming_alloc_est &&
+		   max_pages > 0)
 	{
-		int			sync_state = SyncOneBuffer(next_to_clean, true,
-											   wb_context);
+		int			sync_state = SyncOneBuffer(first_buffer + state->next_to_clean,
+											   true, wb_context);
 
-		if (++next_to_clean >= NBuffers)
+		if (++state->next_to_clean >= nbuffers)
 		{
-			next_to_clean = 0;
-			next_passes++;
+			state->next_to_clean = 0;
+			state->next_passes++;
 		}
 		num_to_scan--;
 
 		if (sync_state & BUF_WRITTEN)
 		{
 			reusable_buffers++;
-			if (++num_written >= bgwriter_lru_maxpages)
+			if (++num_written >= max_pages)
 			{
 				PendingBgWriterStats.maxwritten_clean++;
 				break;
@@ -3871,8 +3977,8 @@ BgBufferSync(WritebackContext *wb_context)
 
 #ifdef BGW_DEBUG
 	elog(DEBUG1, "bgwriter: recent_alloc=%u smoothed=%.2f delta=%ld ahead=%d density=%.2f reusable_est=%d upcoming_est=%d scanned=%d wrote=%d reusable=%d",
-		 recent_alloc, smoothed_alloc, strategy_delta, bufs_ahead,
-		 smoothed_density, reusable_buffers_est, upcoming_alloc_est,
+		 recent_alloc, state->smoothed_alloc, strategy_delta, bufs_ahead,
+		 state->smoothed_density, reusable_buffers_est, upcoming_alloc_est,
 		 bufs_to_lap - num_to_scan,
 		 num_written,
 		 reusable_buffers - reusable_buffers_est);
@@ -3891,13 +3997,13 @@ BgBufferSync(WritebackContext *wb_context)
 	if (new_strategy_delta > 0 && new_recent_alloc > 0)
 	{
 		scans_per_alloc = (float) new_strategy_delta / (float) new_recent_alloc;
-		smoothed_density += (scans_per_alloc - smoothed_density) /
+		state->smoothed_density += (scans_per_alloc - state->smoothed_density) /
 			smoothing_samples;
 
 #ifdef BGW_DEBUG
 		elog(DEBUG2, "bgwriter: cleaner density alloc=%u scan=%ld density=%.2f new smoothed=%.2f",
 			 new_recent_alloc, new_strategy_delta,
-			 scans_per_alloc, smoothed_density);
+			 scans_per_alloc, state->smoothed_density);
 #endif
 	}
 
@@ -3985,6 +4091,174 @@ SyncOneBuffer(int buf_id, bool skip_recently_used, WritebackContext *wb_context)
 	return result | BUF_WRITTEN;
 }
 
+/*
+ * SyncBufferRun -- write out a run of buffers for a checkpoint
+ *
+ * items[] points into the sorted checkpoint array, at up to nitems entries
+ * of the same tablespace.  Starting with the first, we collect the buffers
+ * that hold consecutive blocks of one relation fork and still need to be
+ * written, and write them out with one vectored write.  copy_space, if not
+ * NULL, has room for max_combine pages to be checksummed in.
+ *
+ * Returns the number of entries of items[] that were dealt with, which is at
+ * least one; *nwritten is set to the number of buffers actually written.
+ *
+ * This does the same as calling SyncOneBuffer() on each buffer, except that
+ * all of them are pinned, share-locked and marked as I/O in progress before
+ * any is written.  To avoid deadlocks against backends locking several
+ * pages, only the first content lock is waited for; the run ends at the
+ * first buffer whose lock or I/O can't be acquired immediately, or whose
+ * tag no longer matches the block we expect.
+ */
+static int
+SyncBufferRun(CkptSortItem *items, int nitems, int max_combine,
+			  char *copy_space, WritebackContext *wb_context, int *nwritten)
+{
+	BufferDesc *bufs[MAX_IO_COMBINE_LIMIT];
+	const void *pages[MAX_IO_COMBINE_LIMIT];
+	BufferTag	tag;
+	int			nbufs = 0;
+	bool		permanent = false;
+	XLogRecPtr	max_lsn = InvalidXLogRecPtr;
+	SMgrRelation reln;
+	ErrorContextCallback errcallback;
+	instr_time	io_start;
+
+	Assert(nitems <= max_combine && max_combine <= MAX_IO_COMBINE_LIMIT);
+
+	*nwritten = 0;
+
+	for (int i = 0; i < nitems; i++)
+	{
+		BufferDesc *bufHdr = GetBufferDescriptor(items[i].buf_id);
+		uint32		buf_state;
+
+		/* Make sure we can handle the pin */
+		ReservePrivateRefCountEntry();
+		ResourceOwnerEnlarge(CurrentResourceOwner);
+
+		buf_state = LockBufHdr(bufHdr);
+
+		if (i == 0)
+			tag = bufHdr->tag;
+		else
+			tag.blockNum++;
+
+		if (!(buf_state & BM_CHECKPOINT_NEEDED) ||
+			!(buf_state & BM_VALID) ||
+			!(buf_state & BM_DIRTY) ||
+			!BufferTagsEqual(&bufHdr->tag, &tag))
+		{
+			UnlockBufHdr(bufHdr, buf_state);
+			break;
+		}
+
+		PinBuffer_Locked(bufHdr);
+
+		if (i == 0)
+			LWLockAcquire(BufferDescriptorGetContentLock(bufHdr), LW_SHARED);
+		else if (!LWLockConditionalAcquire(BufferDescriptorGetContentLock(bufHdr),
+										   LW_SHARED))
+		{
+			UnpinBuffer(bufHdr);
+			break;
+		}
+
+		/* If someone else is writing the buffer, leave it to them */
+		if (!StartBufferIO(bufHdr, false, i > 0))
+		{
+			LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
+			UnpinBuffer(bufHdr);
+			break;
+		}
+
+		bufs[nbufs++] = bufHdr;
+	}
+
+	if (nbufs == 0)
+		return 1;
+
+	/* Setup error traceback support for ereport() */
+	errcallback.callback = shared_buffer_write_error_callback;
+	errcallback.arg = bufs[0];
+	errcallback.previous = error_context_stack;
+	error_context_stack = &errcallback;
+
+	reln = smgropen(BufTagGetRelFileLocator(&bufs[0]->tag), INVALID_PROC_NUMBER);
+
+	/*
+	 * As in FlushBuffer(), read each page's LSN under the header lock and
+	 * clear BM_JUST_DIRTIED, then flush WAL once for the whole run.
+	 */
+	for (int i = 0; i < nbufs; i++)
+	{
+		uint32		buf_state = LockBufHdr(bufs[i]);
+		XLogRecPtr	recptr = BufferGetLSN(bufs[i]);
+
+		if (buf_state & BM_PERMANENT)
+			permanent = true;
+		if (recptr > max_lsn)
+			max_lsn = recptr;
+
+		buf_state &= ~BM_JUST_DIRTIED;
+		UnlockBufHdr(bufs[i], buf_state);
+	}
+
+	if (permanent)
+		XLogFlush(max_lsn);
+
+	for (int i = 0; i < nbufs; i++)
+	{
+		Page		page = (Page) BufHdrGetBlock(bufs[i]);
+
+		if (copy_space)
+		{
+			char	   *copy = copy_space + (Size) i * BLCKSZ;
+
+			memcpy(copy, page, BLCKSZ);
+			PageSetChecksumInplace((Page) copy, bufs[i]->tag.blockNum);
+			pages[i] = copy;
+		}
+		else
+		{
+			/* no checksums, so the shared buffer can be written directly */
+			Assert(!DataChecksumsEnabled());
+			pages[i] = page;
+		}
+	}
+
+	io_start = pgstat_prepare_io_time(track_io_timing);
+
+	smgrwritev(reln,
+			   BufTagGetForkNum(&bufs[0]->tag),
+			   bufs[0]->tag.blockNum,
+			   pages,
+			   nbufs,
+			   false);
+
+	pgstat_count_io_op_time(IOOBJECT_RELATION, IOCONTEXT_NORMAL,
+							IOOP_WRITE, io_start, nbufs, (uint64) nbufs * BLCKSZ);
+
+	pgBufferUsage.shared_blks_written += nbufs;
+
+	for (int i = 0; i < nbufs; i++)
+	{
+		tag = bufs[i]->tag;
+
+		TerminateBufferIO(bufs[i], true, 0, true, false);
+		LWLockRelease(BufferDescriptorGetContentLock(bufs[i]));
+		UnpinBuffer(bufs[i]);
+
+		ScheduleBufferTagForWriteback(wb_context, IOCONTEXT_NORMAL, &tag);
+	}
+
+	/* Pop the error context stack */
+	error_context_stack = errcallback.previous;
+
+	*nwritten = nbufs;
+	return nbufs;
+}
+
 /*
  *		AtEOXact_Buffers - clean up at end of transaction.
  *
@@ -17,28 +17,68 @@
 
 #include "pgstat.h"
 #include "port/atomics.h"
+#include "port/pg_numa.h"
 #include "storage/buf_internals.h"
 #include "storage/bufmgr.h"
 #include "storage/proc.h"
 
 #define INT_ACCESS_ONCE(var)	((int)(*((volatile int *)&(var))))
 
+/* Minimum number of buffers in a clock-sweep partition */
+#define MIN_CLOCK_SWEEP_PARTITION_BUFFERS	1024
+
+
+/* GUC variable */
+int			clock_sweep_partitions = 1;
 
 /*
- * The shared freelist control information.
+ * Shared buffers are divided into one or more clock-sweep partitions, each
+ * covering a contiguous range of buffers and having its own clock hand.  With
+ * a single partition this is exactly the traditional clock sweep.  With more
+ * than one, backends sweeping different partitions don't have to bounce the
+ * same cache line between CPUs for every buffer they consider, which matters
+ * on large multi-socket machines.
  */
 typedef struct
 {
-	/* Spinlock: protects the values below */
-	slock_t		buffer_strategy_lock;
-
 	/*
-	 * Clock sweep hand: index of next buffer to consider grabbing. Note that
-	 * this isn't a concrete buffer - we only ever increase the value. So, to
-	 * get an actual buffer, it needs to be used modulo NBuffers.
+	 * Clock sweep hand: index of next buffer to consider grabbing, relative
+	 * to firstBuffer. Note that this isn't a concrete buffer - we only ever
+	 * increase the value. So, to get an actual buffer, it needs to be used
+	 * modulo numBuffers.
 	 */
 	pg_atomic_uint32 nextVictimBuffer;
 
+	int			firstBuffer;	/* first buffer of this partition */
+	int			numBuffers;		/* number of buffers in this partition */
+
+	/*
+	 * Statistics.  These counters should be wide enough that they can't
+	 * overflow during a single bgwriter cycle.  completePasses is protected
+	 * by buffer_strategy_lock.
+	 */
+	uint32		completePasses; /* Complete cycles of the clock sweep */
+	pg_atomic_uint32 numBufferAllocs;	/* Buffers allocated since last reset */
+} ClockSweepPartition;
+
+/* ClockSweepPartition, padded to a full cache line size */
+typedef union ClockSweepPartitionPadded
+{
+	ClockSweepPartition part;
+	char		pad[PG_CACHE_LINE_SIZE];
+} ClockSweepPartitionPadded;
+
+StaticAssertDecl(sizeof(ClockSweepPartition) <= PG_CACHE_LINE_SIZE,
+				 "Miscalculated ClockSweepPartition padding");
+
+/*
+ * The shared freelist control information.
+ */
+typedef struct
+{
+	/* Spinlock: protects the values below */
+	slock_t		buffer_strategy_lock;
+
 	int			firstFreeBuffer;	/* Head of list of unused buffers */
 	int			lastFreeBuffer; /* Tail of list of unused buffers */
 
@@ -47,22 +87,22 @@ typedef struct
 	 * when the list is empty)
 	 */
 
-	/*
-	 * Statistics.  These counters should be wide enough that they can't
-	 * overflow during a single bgwriter cycle.
-	 */
-	uint32		completePasses; /* Complete cycles of the clock sweep */
-	pg_atomic_uint32 numBufferAllocs;	/* Buffers allocated since last reset */
-
 	/*
 	 * Bgworker process to be notified upon activity or -1 if none. See
 	 * StrategyNotifyBgWriter.
 	 */
 	int			bgwprocno;
+
+	/* Number of clock-sweep partitions, fixed at startup */
+	int			numPartitions;
+
+	/* Do the partitions correspond to NUMA nodes? */
+	bool		numaPartitions;
 } BufferStrategyControl;
 
 /* Pointers to shared state */
 static BufferStrategyControl *StrategyControl = NULL;
+static ClockSweepPartitionPadded *ClockSweepPartitions = NULL;
 
 /*
  * Private (non-shared) state for managing a ring of shared buffers to re-use.
@@ -97,16 +137,18 @@ static BufferDesc *GetBufferFromRing(BufferAccessStrategy strategy,
 									 uint32 *buf_state);
 static void AddBufferToRing(BufferAccessStrategy strategy,
 							BufferDesc *buf);
+static int	StrategyChoosePartitions(bool *numa_partitions);
 
 /*
  * ClockSweepTick - Helper routine for StrategyGetBuffer()
  *
- * Move the clock hand one buffer ahead of its current position and return the
- * id of the buffer now under the hand.
+ * Move the given partition's clock hand one buffer ahead of its current
+ * position and return the id of the buffer now under the hand.
  */
 static inline uint32
-ClockSweepTick(void)
+ClockSweepTick(ClockSweepPartition *partition)
 {
+	uint32		nbuffers = partition->numBuffers;
 	uint32		victim;
 
 	/*
@@ -115,14 +157,14 @@ ClockSweepTick(void)
 	 * apparent order.
 	 */
 	victim =
-		pg_atomic_fetch_add_u32(&StrategyControl->nextVictimBuffer, 1);
+		pg_atomic_fetch_add_u32(&partition->nextVictimBuffer, 1);
 
-	if (victim >= NBuffers)
+	if (victim >= nbuffers)
 	{
 		uint32		originalVictim = victim;
 
 		/* always wrap what we look up in BufferDescriptors */
-		victim = victim % NBuffers;
+		victim = victim % nbuffers;
 
 		/*
 		 * If we're the one that just caused a wraparound, force
@@ -150,17 +192,101 @@ ClockSweepTick(void)
 				 */
 				SpinLockAcquire(&StrategyControl->buffer_strategy_lock);
 
-				wrapped = expected % NBuffers;
+				wrapped = expected % nbuffers;
 
-				success = pg_atomic_compare_exchange_u32(&StrategyControl->nextVictimBuffer,
+				success = pg_atomic_compare_exchange_u32(&partition->nextVictimBuffer,
 														 &expected, wrapped);
 				if (success)
-					StrategyControl->completePasses++;
+					partition->completePasses++;
 				SpinLockRelease(&StrategyControl->buffer_strategy_lock);
 			}
 		}
 	}
-	return victim;
+	return partition->firstBuffer + victim;
+}
+
+/*
+ * ClockSweepHomePartition - choose the partition to sweep first
+ *
+ * When the partitions correspond to NUMA nodes, prefer the node we're
+ * currently running on, so that the buffers we recycle (and the memory the
+ * kernel places them in on first touch) tend to be local.  Otherwise just
+ * spread backends evenly over the partitions.
+ */
+static inline int
+ClockSweepHomePartition(void)
+{
+	int			npartitions = StrategyControl->numPartitions;
+
+	if (npartitions == 1)
+		return 0;
+
+	if (StrategyControl->numaPartitions)
+	{
+		int			node = pg_numa_get_current_node();
+
+		if (node >= 0 && node < npartitions)
+			return node;
+	}
+
+	if (MyProcNumber != INVALID_PROC_NUMBER)
+		return MyProcNumber % npartitions;
+
+	return MyProcPid % npartitions;
+}
+
+/*
+ * ClockSweepGetBuffer - Helper routine for StrategyGetBuffer()
+ *
+ * Run the clock sweep over a single partition.  Returns NULL if every buffer
+ * in the partition is pinned (or was when we looked at it); otherwise the
+ * selected buffer is returned with its header spinlock held.
+ */
+static BufferDesc *
+ClockSweepGetBuffer(ClockSweepPartition *partition, uint32 *buf_state)
+{
+	BufferDesc *buf;
+	int			trycounter;
+	uint32		local_buf_state;	/* to avoid repeated (de-)referencing */
+
+	trycounter = partition->numBuffers;
+	for (;;)
+	{
+		buf = GetBufferDescriptor(ClockSweepTick(partition));
+
+		/*
+		 * If the buffer is pinned or has a nonzero usage_count, we cannot use
+		 * it; decrement the usage_count (unless pinned) and keep scanning.
+		 */
+		local_buf_state = LockBufHdr(buf);
+
+		if (BUF_STATE_GET_REFCOUNT(local_buf_state) == 0)
+		{
+			if (BUF_STATE_GET_USAGECOUNT(local_buf_state) != 0)
+			{
+				local_buf_state -= BUF_USAGECOUNT_ONE;
+
+				trycounter = partition->numBuffers;
+			}
+			else
+			{
+				/* Found a usable buffer */
+				*buf_state = local_buf_state;
+				return buf;
+			}
+		}
+		else if (--trycounter == 0)
+		{
+			/*
+			 * We've scanned all the buffers of the partition without making
+			 * any state changes, so they're all pinned (or were when we
+			 * looked at them).
+			 */
+			UnlockBufHdr(buf, local_buf_state);
+			return NULL;
+		}
+		UnlockBufHdr(buf, local_buf_state);
+	}
 }
 
 /*
@@ -197,7 +323,8 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state, bool *from_r
 {
 	BufferDesc *buf;
 	int			bgwprocno;
-	int			trycounter;
+	int			home_partition;
+	int			partition;
 	uint32		local_buf_state;	/* to avoid repeated (de-)referencing */
 
 	*from_ring = false;
@@ -245,9 +372,12 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state, bool *from_r
 	/*
 	 * We count buffer allocation requests so that the bgwriter can estimate
 	 * the rate of buffer consumption.  Note that buffers recycled by a
-	 * strategy object are intentionally not counted here.
+	 * strategy object are intentionally not counted here.  Allocations are
+	 * counted in the partition we sweep first, to avoid having all backends
+	 * update a single counter.
 	 */
-	pg_atomic_fetch_add_u32(&StrategyControl->numBufferAllocs, 1);
+	home_partition = ClockSweepHomePartition();
+	pg_atomic_fetch_add_u32(&ClockSweepPartitions[home_partition].part.numBufferAllocs, 1);
 
 	/*
 	 * First check, without acquiring the lock, whether there's buffers in the
@@ -311,49 +441,36 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state, bool *from_r
 		}
 	}
 
-	/* Nothing on the freelist, so run the "clock sweep" algorithm */
-	trycounter = NBuffers;
-	for (;;)
+	/*
+	 * Nothing on the freelist, so run the "clock sweep" algorithm, starting
+	 * with our home partition.  If all buffers there are pinned, move on to
+	 * the other partitions.
+	 */
+	partition = home_partition;
+	do
 	{
-		buf = GetBufferDescriptor(ClockSweepTick());
-
-		/*
-		 * If the buffer is pinned or has a nonzero usage_count, we cannot use
-		 * it; decrement the usage_count (unless pinned) and keep scanning.
-		 */
-		local_buf_state = LockBufHdr(buf);
-
-		if (BUF_STATE_GET_REFCOUNT(local_buf_state) == 0)
-		{
-			if (BUF_STATE_GET_USAGECOUNT(local_buf_state) != 0)
-			{
-				local_buf_state -= BUF_USAGECOUNT_ONE;
-
-				trycounter = NBuffers;
-			}
-			else
-			{
-				/* Found a usable buffer */
-				if (strategy != NULL)
-					AddBufferToRing(strategy, buf);
-				*buf_state = local_buf_state;
-				return buf;
-			}
-		}
-		else if (--trycounter == 0)
+		buf = ClockSweepGetBuffer(&ClockSweepPartitions[partition].part,
+								  &local_buf_state);
+		if (buf != NULL)
 		{
-			/*
-			 * We've scanned all the buffers without making any state changes,
-			 * so all the buffers are pinned (or were when we looked at them).
-			 * We could hope that someone will free one eventually, but it's
-			 * probably better to fail than to risk getting stuck in an
-			 * infinite loop.
-			 */
-			UnlockBufHdr(buf, local_buf_state);
-			elog(ERROR, "no unpinned buffers available");
+			if (strategy != NULL)
+				AddBufferToRing(strategy, buf);
+			*buf_state = local_buf_state;
+			return buf;
 		}
-		UnlockBufHdr(buf, local_buf_state);
-	}
+
+		if (++partition >= StrategyControl->numPartitions)
+			partition = 0;
+	} while (partition != home_partition);
+
+	/*
+	 * We've scanned all the buffers without making any state changes, so all
+	 * the buffers are pinned (or were when we looked at them).  We could hope
+	 * that someone will free one eventually, but it's probably better to fail
+	 * than to risk getting stuck in an infinite loop.
+	 */
+	elog(ERROR, "no unpinned buffers available");
+	return NULL;				/* keep compiler quiet */
 }
 
 /*
@@ -379,11 +496,36 @@ StrategyFreeBuffer(BufferDesc *buf)
 	SpinLockRelease(&StrategyControl->buffer_strategy_lock);
 }
 
+/*
+ * StrategyNumPartitions -- number of clock-sweep partitions
+ */
+int
+StrategyNumPartitions(void)
+{
+	return StrategyControl->numPartitions;
+}
+
+/*
+ * StrategyPartitionRange -- report the range of buffers in a partition
+ */
+void
+StrategyPartitionRange(int partition, int *first_buffer, int *num_buffers)
+{
+	ClockSweepPartition *part;
+
+	Assert(partition >= 0 && partition < StrategyControl->numPartitions);
+	part = &ClockSweepPartitions[partition].part;
+
+	*first_buffer = part->firstBuffer;
+	*num_buffers = part->numBuffers;
+}
+
 /*
  * StrategySyncStart -- tell BgBufferSync where to start syncing
  *
- * The result is the buffer index of the best buffer to sync first.
- * BgBufferSync() will proceed circularly around the buffer array from there.
+ * The result is the buffer index of the best buffer to sync first in the
+ * given clock-sweep partition.  BgBufferSync() will proceed circularly around
+ * the partition's buffers from there.
  *
  * In addition, we return the completed-pass count (which is effectively
  * the higher-order bits of nextVictimBuffer) and the count of recent buffer
@@ -391,29 +533,34 @@ StrategyFreeBuffer(BufferDesc *buf)
  * being read.
  */
 int
-StrategySyncStart(uint32 *complete_passes, uint32 *num_buf_alloc)
+StrategySyncStart(int partition, uint32 *complete_passes,
+				  uint32 *num_buf_alloc)
 {
+	ClockSweepPartition *part;
 	uint32		nextVictimBuffer;
 	int			result;
 
+	Assert(partition >= 0 && partition < StrategyControl->numPartitions);
+	part = &ClockSweepPartitions[partition].part;
+
 	SpinLockAcquire(&StrategyControl->buffer_strategy_lock);
-	nextVictimBuffer = pg_atomic_read_u32(&StrategyControl->nextVictimBuffer);
-	result = nextVictimBuffer % NBuffers;
+	nextVictimBuffer = pg_atomic_read_u32(&part->nextVictimBuffer);
+	result = part->firstBuffer + nextVictimBuffer % part->numBuffers;
 
 	if (complete_passes)
 	{
-		*complete_passes = StrategyControl->completePasses;
+		*complete_passes = part->completePasses;
 
 		/*
 		 * Additionally add the number of wraparounds that happened before
 		 * completePasses could be incremented. C.f. ClockSweepTick().
 		 */
-		*complete_passes += nextVictimBuffer / NBuffers;
+		*complete_passes += nextVictimBuffer / part->numBuffers;
 	}
 
 	if (num_buf_alloc)
 	{
-		*num_buf_alloc = pg_atomic_exchange_u32(&StrategyControl->numBufferAllocs, 0);
+		*num_buf_alloc = pg_atomic_exchange_u32(&part->numBufferAllocs, 0);
 	}
 	SpinLockRelease(&StrategyControl->buffer_strategy_lock);
 	return result;
@@ -441,6 +588,47 @@ StrategyNotifyBgWriter(int bgwprocno)
 }
 
 
+/*
+ * StrategyChoosePartitions
+ *
+ * Work out how many clock-sweep partitions to divide shared buffers into,
+ * based on clock_sweep_partitions.  If numa_partitions isn't NULL, it's set
+ * to whether the partitions correspond to NUMA nodes.
+ */
+static int
+StrategyChoosePartitions(bool *numa_partitions)
+{
+	int			npartitions = clock_sweep_partitions;
+	bool		numa = false;
+
+	if (npartitions == 0)
+	{
+		/* one partition per NUMA node, if we know about NUMA at all */
+		if (pg_numa_init() != -1)
+		{
+			/*
+			 * clock_sweep_partitions itself can't exceed this, so neither
+			 * may the node count; backends on the nodes beyond it pick a
+			 * partition by ClockSweepHomePartition's fallback rule.
+			 */
+			npartitions = Min(pg_numa_get_max_node() + 1,
+							  MAX_CLOCK_SWEEP_PARTITIONS);
+			numa = true;
+		}
+		else
+			npartitions = 1;
+	}
+
+	/* don't let the partitions get unreasonably small */
+	npartitions = Min(npartitions, NBuffers / MIN_CLOCK_SWEEP_PARTITION_BUFFERS);
+	npartitions = Max(npartitions, 1);
+
+	if (numa_partitions)
+		*numa_partitions = numa && npartitions > 1;
+
+	return npartitions;
+}
+
 /*
  * StrategyShmemSize
  *
@@ -460,6 +648,10 @@ StrategyShmemSize(void)
 	/* size of the shared replacement strategy control block */
 	size = add_size(size, MAXALIGN(sizeof(BufferStrategyControl)));
 
+	/* size of the clock-sweep partitions */
+	size = add_size(size, mul_size(StrategyChoosePartitions(NULL),
+								   sizeof(ClockSweepPartitionPadded)));
+
 	return size;
 }
 
@@ -474,6 +666,11 @@ void
 StrategyInitialize(bool init)
 {
 	bool		found;
+	bool		found_partitions;
+	bool		numa_partitions;
+	int			npartitions;
+
+	npartitions = StrategyChoosePartitions(&numa_partitions);
 
 	/*
 	 * Initialize the shared buffer lookup hashtable.
@@ -495,6 +692,12 @@ StrategyInitialize(bool init)
 						sizeof(BufferStrategyControl),
 						&found);
 
+	ClockSweepPartitions = (ClockSweepPartitionPadded *)
+		ShmemInitStruct("Buffer Clock Sweep Partitions",
+						mul_size(npartitions, sizeof(ClockSweepPartitionPadded)),
+						&found_partitions);
+	Assert(found == found_partitions);
+
 	if (!found)
 	{
 		/*
@@ -511,15 +714,30 @@ StrategyInitialize(bool init)
 		StrategyControl->firstFreeBuffer = 0;
 		StrategyControl->lastFreeBuffer = NBuffers - 1;
 
-		/* Initialize the clock sweep pointer */
-		pg_atomic_init_u32(&StrategyControl->nextVictimBuffer, 0);
-
-		/* Clear statistics */
-		StrategyControl->completePasses = 0;
-		pg_atomic_init_u32(&StrategyControl->numBufferAllocs, 0);
-
 		/* No pending notification */
 		StrategyControl->bgwprocno = -1;
+
+		/*
+		 * Divide the buffers into partitions of (nearly) equal size, and
+		 * initialize the clock sweep pointers.
+		 */
+		StrategyControl->numPartitions = npartitions;
+		StrategyControl->numaPartitions = numa_partitions;
+
+		for (int i = 0; i < npartitions; i++)
+		{
+			ClockSweepPartition *part = &ClockSweepPartitions[i].part;
+			int			first = (int) (((int64) NBuffers * i) / npartitions);
+			int			next = (int) (((int64) NBuffers * (i + 1)) / npartitions);
+
+			part->firstBuffer = first;
+			part->numBuffers = next - first;
+			pg_atomic_init_u32(&part->nextVictimBuffer, 0);
+
+			/* Clear statistics */
+			part->completePasses = 0;
+			pg_atomic_init_u32(&part->numBufferAllocs, 0);
+		}
 	}
 	else
 		Assert(!init);
@@ -2088,8 +2088,8 @@ GetMaxSnapshotSubxidCount(void)
  * the fields that need to change and returns true. Otherwise it returns
  * false.
  *
- * This very likely can be evolved to not need ProcArrayLock held (at very
- * least in the case we already hold a snapshot), but that's for another day.
+ * See GetSnapshotDataReuseNoLock() for a variant that doesn't need
+ * ProcArrayLock, for the case that we already hold a snapshot.
  */
 static bool
 GetSnapshotDataReuse(Snapshot snapshot)
@@ -2139,6 +2139,62 @@ GetSnapshotDataReuse(Snapshot snapshot)
 	return true;
 }
 
+/*
+ * Like GetSnapshotDataReuse(), but without holding ProcArrayLock.
+ *
+ * This is only possible if our PGPROC already advertises an xmin that is not
+ * newer than the snapshot's, which is the case whenever we already hold
+ * another snapshot built while xactCompletionCount had the same value.  We
+ * then don't need to (re-)enter anything into the PGPROC array, and the only
+ * question is whether any transaction with an xid completed since the
+ * snapshot was built.
+ *
+ * Reading xactCompletionCount without the lock can race with a transaction
+ * that is in the middle of ProcArrayEndTransaction().  That's OK: the
+ * transaction is not yet visibly committed to anybody, so treating it as
+ * still running is equivalent to having taken the snapshot slightly earlier.
+ * The memory barrier ensures that we see the increments of all transactions
+ * that completed before we were called.
+ *
+ * This requires that 8 byte values can be read without tearing, as
+ * xactCompletionCount isn't an atomic variable.
+ */
+static bool
+GetSnapshotDataReuseNoLock(Snapshot snapshot)
+{
+#ifdef PG_HAVE_8BYTE_SINGLE_COPY_ATOMICITY
+	TransactionId myxmin;
+	uint64		curXactCompletionCount;
+
+	if (unlikely(snapshot->snapXactCompletionCount == 0))
+		return false;
+
+	myxmin = MyProc->xmin;
+	if (!TransactionIdIsValid(myxmin) ||
+		!TransactionIdPrecedesOrEquals(myxmin, snapshot->xmin))
+		return false;
+
+	pg_memory_barrier();
+
+	curXactCompletionCount =
+		*((volatile uint64 *) &TransamVariables->xactCompletionCount);
+	if (curXactCompletionCount != snapshot->snapXactCompletionCount)
+		return false;
+
+	RecentXmin = snapshot->xmin;
+	Assert(TransactionIdPrecedesOrEquals(TransactionXmin, RecentXmin));
+
+	snapshot->curcid = GetCurrentCommandId(false);
+	snapshot->active_count = 0;
+	snapshot->regd_count = 0;
+	snapshot->copied = false;
+
+	return true;
+#else
+	return false;
+#endif
+}
+
 /*
  * GetSnapshotData -- returns information about running transactions.
  *
@@ -2224,6 +2280,13 @@ GetSnapshotData(Snapshot snapshot)
 					 errmsg("out of memory")));
 	}
 
+	/*
+	 * If we already hold a snapshot and nothing changed since, we can reuse
+	 * the previous contents without even acquiring ProcArrayLock.
+	 */
+	if (GetSnapshotDataReuseNoLock(snapshot))
+		return snapshot;
+
 	/*
 	 * It is sufficient to get shared lock on ProcArrayLock, even if we are
 	 * going to set MyProc->xmin.
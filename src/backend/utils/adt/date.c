@@ -128,6 +128,14 @@ date_in(PG_FUNCTION_ARGS)
 	char		workbuf[MAXDATELEN + 1];
 	DateTimeErrorExtra extra;
 
+	/* Try the fast path for plain ISO input first */
+	if (DecodeISODateTimeFast(str, false, tm, &fsec))
+	{
+		/* always valid by construction, see DecodeISODateTimeFast */
+		date = date2j(tm->tm_year, tm->tm_mon, tm->tm_mday) - POSTGRES_EPOCH_JDATE;
+		PG_RETURN_DATEADT(date);
+	}
+
 	dterr = ParseDateTime(str, workbuf, sizeof(workbuf),
 						  field, ftype, MAXDATEFIELDS, &nf);
 	if (dterr == 0)
@@ -966,6 +966,93 @@ ParseDateTime(const char *timestr, char *workbuf, size_t buflen,
 }
 
 
+/*
+ * Read exactly ndigits decimal digits from str into *result.
+ */
+static inline bool
+read_fixed_digits(const char *str, int ndigits, int *result)
+{
+	int			val = 0;
+
+	for (int i = 0; i < ndigits; i++)
+	{
+		if (!isdigit((unsigned char) str[i]))
+			return false;
+		val = val * 10 + (str[i] - '0');
+	}
+	*result = val;
+	return true;
+}
+
+/* DecodeISODateTimeFast()
+ * Try to interpret a string in the strict ISO 8601 form
+ *		"YYYY-MM-DD" or "YYYY-MM-DD HH:MM:SS[.ffffff]"
+ * (with 'T' also allowed as the date/time separator, and no time zone),
+ * without going through ParseDateTime() and DecodeDateTime().  This is the
+ * form we emit ourselves with DateStyle ISO, and so the common case when
+ * loading data.  If allow_time is false, only the date form is accepted.
+ *
+ * Returns true and fills *tm and *fsec if the whole string was in that form
+ * and all fields are in range.  Otherwise returns false; the caller must then
+ * use the general code path, which will also produce any error message.
+ */
+bool
+DecodeISODateTimeFast(const char *str, bool allow_time,
+					  struct pg_tm *tm, fsec_t *fsec)
+{
+	if (!read_fixed_digits(str, 4, &tm->tm_year) || str[4] != '-' ||
+		!read_fixed_digits(str + 5, 2, &tm->tm_mon) || str[7] != '-' ||
+		!read_fixed_digits(str + 8, 2, &tm->tm_mday))
+		return false;
+	if (tm->tm_year < 1 ||
+		tm->tm_mon < 1 || tm->tm_mon > MONTHS_PER_YEAR ||
+		tm->tm_mday < 1 ||
+		tm->tm_mday > day_tab[isleap(tm->tm_year)][tm->tm_mon - 1])
+		return false;
+
+	tm->tm_hour = 0;
+	tm->tm_min = 0;
+	tm->tm_sec = 0;
+	*fsec = 0;
+	str += 10;
+
+	if (*str == '\0')
+		return true;
+	if (!allow_time || (*str != ' ' && *str != 'T'))
+		return false;
+
+	if (!read_fixed_digits(str + 1, 2, &tm->tm_hour) || str[3] != ':' ||
+		!read_fixed_digits(str + 4, 2, &tm->tm_min) || str[6] != ':' ||
+		!read_fixed_digits(str + 7, 2, &tm->tm_sec))
+		return false;
+	/* leave 24:00:00 and leap seconds to the general code */
+	if (tm->tm_hour >= HOURS_PER_DAY ||
+		tm->tm_min >= MINS_PER_HOUR ||
+		tm->tm_sec >= SECS_PER_MINUTE)
+		return false;
+	str += 9;
+
+	if (*str == '.')
+	{
+		int			scale = USECS_PER_SEC;
+
+		str++;
+		if (!isdigit((unsigned char) *str))
+			return false;
+		/* more than microsecond precision needs rounding; don't bother */
+		while (isdigit((unsigned char) *str))
+		{
+			if (scale == 1)
+				return false;
+			scale /= 10;
+			*fsec += (*str++ - '0') * scale;
+		}
+	}
+
+	return *str == '\0';
+}
+
+
 /* DecodeDateTime()
  * Interpret previously parsed fields for general date and time.
  * Return 0 if full date, 1 if only time, and negative DTERR code if problems.
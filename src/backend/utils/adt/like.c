@@ -127,6 +127,7 @@ SB_lower_char(unsigned char c, pg_locale_t locale)
 
 #define MatchText	SB_MatchText
 #define do_like_escape	SB_do_like_escape
+#define MATCH_BYTE_SEARCH
 
 #include "like_match.c"
 
@@ -142,6 +143,8 @@ SB_lower_char(unsigned char c, pg_locale_t locale)
 #define NextChar(p, plen) \
 	do { (p)++; (plen)--; } while ((plen) > 0 && (*(p) & 0xC0) == 0x80 )
 #define MatchText	UTF8_MatchText
+/* a lead byte never equals a continuation byte, so byte search is safe */
+#define MATCH_BYTE_SEARCH
 
 #include "like_match.c"
 
@@ -15,6 +15,8 @@
  * MatchText - to name of function wanted
  * do_like_escape - name of function if wanted - needs CHAREQ and CopyAdvChar
  * MATCH_LOWER - define for case (4) to specify case folding for 1-byte chars
+ * MATCH_BYTE_SEARCH - define if a pattern byte can only match the text at a
+ *		character boundary, so candidate positions can be found with memchr()
  *
  * Copyright (c) 1996-2025, PostgreSQL Global Development Group
  *
@@ -172,6 +174,36 @@ MatchText(const char *t, int tlen, const char *p, int plen, pg_locale_t locale)
 			else
 				firstpat = GETCHAR(*p, locale);
 
+#ifdef MATCH_BYTE_SEARCH
+
+			/*
+			 * When a matching first byte is guaranteed to start a character,
+			 * let memchr() find the candidate positions; it is typically much
+			 * faster than stepping through the text ourselves.
+			 */
+			if (!locale || locale->deterministic)
+			{
+				while (tlen > 0)
+				{
+					const char *next = memchr(t, firstpat, tlen);
+					int			matched;
+
+					if (next == NULL)
+						break;
+					tlen -= next - t;
+					t = next;
+
+					matched = MatchText(t, tlen, p, plen, locale);
+					if (matched != LIKE_FALSE)
+						return matched; /* TRUE or ABORT */
+
+					NextChar(t, tlen);
+				}
+
+				return LIKE_ABORT;
+			}
+#endif
+
 			while (tlen > 0)
 			{
 				if (GETCHAR(*t, locale) == firstpat || (locale && !locale->deterministic))
@@ -498,6 +530,10 @@ do_like_escape(text *pat, text *esc)
 
 #undef GETCHAR
 
+#ifdef MATCH_BYTE_SEARCH
+#undef MATCH_BYTE_SEARCH
+#endif
+
 #ifdef MATCH_LOWER
 #undef MATCH_LOWER
 
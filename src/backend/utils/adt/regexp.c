@@ -88,11 +88,16 @@ typedef struct regexp_matches_ctx
  * patterns are seen will "fail to keep up" and will drop off the end of the
  * cache.  With move-to-front, a reusable pattern is guaranteed to stay in
  * the cache as long as it's used at least once in every MAX_CACHED_RES uses.
+ *
+ * The list itself is an array of pointers, with each entry allocated in its
+ * own memory context.  That keeps move-to-front cheap even with a cache of a
+ * few hundred entries, which workloads cycling through many distinct
+ * patterns need to avoid recompiling on every call.
  */
 
 /* this is the maximum number of cached regular expressions */
 #ifndef MAX_CACHED_RES
-#define MAX_CACHED_RES	32
+#define MAX_CACHED_RES	256
 #endif
 
 /* A parent memory context for regular expressions. */
@@ -110,7 +115,7 @@ typedef struct cached_re_str
 } cached_re_str;
 
 static int	num_res = 0;		/* # of cached re's */
-static cached_re_str re_array[MAX_CACHED_RES];	/* cached re's */
+static cached_re_str *re_array[MAX_CACHED_RES];	/* cached re's */
 
 
 /* Local functions */
@@ -147,6 +152,7 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 	int			i;
 	int			regcomp_result;
 	cached_re_str re_temp;
+	cached_re_str *cre;
 	char		errMsg[100];
 	MemoryContext oldcontext;
 
@@ -157,22 +163,23 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 	 */
 	for (i = 0; i < num_res; i++)
 	{
-		if (re_array[i].cre_pat_len == text_re_len &&
-			re_array[i].cre_flags == cflags &&
-			re_array[i].cre_collation == collation &&
-			memcmp(re_array[i].cre_pat, text_re_val, text_re_len) == 0)
+		cre = re_array[i];
+
+		if (cre->cre_pat_len == text_re_len &&
+			cre->cre_flags == cflags &&
+			cre->cre_collation == collation &&
+			memcmp(cre->cre_pat, text_re_val, text_re_len) == 0)
 		{
 			/*
 			 * Found a match; move it to front if not there already.
 			 */
 			if (i > 0)
 			{
-				re_temp = re_array[i];
-				memmove(&re_array[1], &re_array[0], i * sizeof(cached_re_str));
-				re_array[0] = re_temp;
+				memmove(&re_array[1], &re_array[0], i * sizeof(cached_re_str *));
+				re_array[0] = cre;
 			}
 
-			return &re_array[0].cre_re;
+			return &cre->cre_re;
 		}
 	}
 
@@ -238,6 +245,10 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 	re_temp.cre_flags = cflags;
 	re_temp.cre_collation = collation;
 
+	/* The cache entry itself lives in the per-regexp memory context, too. */
+	cre = palloc_object(cached_re_str);
+	*cre = re_temp;
+
 	/*
 	 * Okay, we have a valid new item in re_temp; insert it into the storage
 	 * array.  Discard last entry if needed.
@@ -247,21 +258,21 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 		--num_res;
 		Assert(num_res < MAX_CACHED_RES);
 		/* Delete the memory context holding the regexp and pattern. */
-		MemoryContextDelete(re_array[num_res].cre_context);
+		MemoryContextDelete(re_array[num_res]->cre_context);
 	}
 
 	/* Re-parent the memory context to our long-lived cache context. */
 	MemoryContextSetParent(re_temp.cre_context, RegexpCacheMemoryContext);
 
 	if (num_res > 0)
-		memmove(&re_array[1], &re_array[0], num_res * sizeof(cached_re_str));
+		memmove(&re_array[1], &re_array[0], num_res * sizeof(cached_re_str *));
 
-	re_array[0] = re_temp;
+	re_array[0] = cre;
 	num_res++;
 
 	MemoryContextSwitchTo(oldcontext);
 
-	return &re_array[0].cre_re;
+	return &cre->cre_re;
 }
 
 /*
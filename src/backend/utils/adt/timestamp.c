@@ -184,6 +184,17 @@ timestamp_in(PG_FUNCTION_ARGS)
 	char		workbuf[MAXDATELEN + MAXDATEFIELDS];
 	DateTimeErrorExtra extra;
 
+	/* Try the fast path for plain ISO input first */
+	if (DecodeISODateTimeFast(str, true, tm, &fsec))
+	{
+		if (tm2timestamp(tm, fsec, NULL, &result) != 0)
+			ereturn(escontext, (Datum) 0,
+					(errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE),
+					 errmsg("timestamp out of range: \"%s\"", str)));
+		AdjustTimestampForTypmod(&result, typmod, escontext);
+		PG_RETURN_TIMESTAMP(result);
+	}
+
 	dterr = ParseDateTime(str, workbuf, sizeof(workbuf),
 						  field, ftype, MAXDATEFIELDS, &nf);
 	if (dterr == 0)
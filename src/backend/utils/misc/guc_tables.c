@@ -460,6 +460,9 @@ static const struct config_enum_entry default_toast_compression_options[] = {
 	{"pglz", TOAST_PGLZ_COMPRESSION, false},
 #ifdef  USE_LZ4
 	{"lz4", TOAST_LZ4_COMPRESSION, false},
+#endif
+#ifdef  USE_ZSTD
+	{"zstd", TOAST_ZSTD_COMPRESSION, false},
 #endif
 	{NULL, 0, false}
 };
@@ -1999,6 +2002,16 @@ struct config_bool ConfigureNamesBool[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"backend_huge_pages", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Requests transparent huge pages for large blocks of backend-local memory."),
+			NULL
+		},
+		&backend_huge_pages,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"parallel_leader_participation", PGC_USERSET, RESOURCES_WORKER_PROCESSES,
 			gettext_noop("Controls whether Gather and Gather Merge also run subplans."),
@@ -2376,6 +2389,16 @@ struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"clock_sweep_partitions", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the number of clock-sweep partitions of shared buffers."),
+			gettext_noop("0 means one partition per NUMA node.")
+		},
+		&clock_sweep_partitions,
+		1, 0, MAX_CLOCK_SWEEP_PARTITIONS,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"vacuum_buffer_usage_limit", PGC_USERSET, RESOURCES_MEM,
 			gettext_noop("Sets the buffer pool size for VACUUM, ANALYZE, and autovacuum."),
@@ -3111,11 +3134,11 @@ struct config_int ConfigureNamesInt[] =
 		{"commit_delay", PGC_SUSET, WAL_SETTINGS,
 			gettext_noop("Sets the delay in microseconds between transaction commit and "
 						 "flushing WAL to disk."),
-			NULL
+			gettext_noop("-1 means derive the delay from the duration of recent WAL flushes.")
 			/* we have no microseconds designation, so can't supply units here */
 		},
 		&CommitDelay,
-		0, 0, 100000,
+		0, -1, MAX_COMMIT_DELAY,
 		NULL, NULL, NULL
 	},
 
@@ -4110,6 +4133,16 @@ struct config_real ConfigureNamesReal[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"autovacuum_freeze_debt_scale_factor", PGC_SIGHUP, VACUUM_AUTOVACUUM,
+			gettext_noop("Fraction of table pages that are all-visible but not all-frozen prior to vacuum."),
+			gettext_noop("-1 disables vacuums triggered by unfrozen all-visible pages.")
+		},
+		&autovacuum_freeze_debt_scale,
+		-1, -1.0, 1.0,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"checkpoint_completion_target", PGC_SIGHUP, WAL_CHECKPOINTS,
 			gettext_noop("Time spent flushing dirty buffers during checkpoint, as fraction of checkpoint interval."),
@@ -716,6 +716,7 @@ AllocSetAllocLarge(MemoryContext context, Size size, int flags)
 	if (block == NULL)
 		return MemoryContextAllocationFailure(context, size, flags);
 
+	MemoryContextAdviseHugePages(block, blksize);
 	context->mem_allocated += blksize;
 
 	block->aset = set;
@@ -922,6 +923,7 @@ AllocSetAllocFromNewBlock(MemoryContext context, Size size, int flags,
 	if (block == NULL)
 		return MemoryContextAllocationFailure(context, size, flags);
 
+	MemoryContextAdviseHugePages(block, blksize);
 	context->mem_allocated += blksize;
 
 	block->aset = set;
@@ -318,6 +318,7 @@ BumpAllocLarge(MemoryContext context, Size size, int flags)
 	if (block == NULL)
 		return MemoryContextAllocationFailure(context, size, flags);
 
+	MemoryContextAdviseHugePages(block, blksize);
 	context->mem_allocated += blksize;
 
 	/* the block is completely full */
@@ -455,6 +456,7 @@ BumpAllocFromNewBlock(MemoryContext context, Size size, int flags,
 	if (block == NULL)
 		return MemoryContextAllocationFailure(context, size, flags);
 
+	MemoryContextAdviseHugePages(block, blksize);
 	context->mem_allocated += blksize;
 
 	/* initialize the new block */
@@ -365,6 +365,7 @@ GenerationAllocLarge(MemoryContext context, Size size, int flags)
 	if (block == NULL)
 		return MemoryContextAllocationFailure(context, size, flags);
 
+	MemoryContextAdviseHugePages(block, blksize);
 	context->mem_allocated += blksize;
 
 	/* block with a single (used) chunk */
@@ -487,6 +488,7 @@ GenerationAllocFromNewBlock(MemoryContext context, Size size, int flags,
 	if (block == NULL)
 		return MemoryContextAllocationFailure(context, size, flags);
 
+	MemoryContextAdviseHugePages(block, blksize);
 	context->mem_allocated += blksize;
 
 	/* initialize the new block */
@@ -21,6 +21,10 @@
 
 #include "postgres.h"
 
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+
 #include "mb/pg_wchar.h"
 #include "miscadmin.h"
 #include "utils/memdebug.h"
@@ -157,6 +161,9 @@ MemoryContext CurTransactionContext = NULL;
 /* This is a transient link to the active portal's memory context: */
 MemoryContext PortalContext = NULL;
 
+/* GUC variable */
+bool		backend_huge_pages = false;
+
 static void MemoryContextDeleteOnly(MemoryContext context);
 static void MemoryContextCallResetCallbacks(MemoryContext context);
 static void MemoryContextStatsInternal(MemoryContext context, int level,
@@ -1163,6 +1170,29 @@ MemoryContextAllocationFailure(MemoryContext context, Size size, int flags)
 	return NULL;
 }
 
+/*
+ * MemoryContextAdviseHugePagesInternal
+ *		Ask the kernel to back the huge-page-aligned part of a freshly
+ *		malloc'd block with transparent huge pages.  Use the inline wrapper
+ *		MemoryContextAdviseHugePages() instead of calling this directly.
+ *
+ * malloc() gives no alignment guarantee beyond MAXALIGN, so only the whole
+ * huge pages inside [block, block + size) are covered.  Failure is harmless
+ * and ignored; the memory just stays on normal pages.
+ */
+void
+MemoryContextAdviseHugePagesInternal(void *block, Size size)
+{
+#ifdef MADV_HUGEPAGE
+	uintptr_t	start = TYPEALIGN(MEMORY_CONTEXT_HUGE_PAGE_SIZE, block);
+	uintptr_t	end = TYPEALIGN_DOWN(MEMORY_CONTEXT_HUGE_PAGE_SIZE,
+									 (uintptr_t) block + size);
+
+	if (end > start)
+		(void) madvise((void *) start, end - start, MADV_HUGEPAGE);
+#endif
+}
+
 /*
  * MemoryContextSizeFailure
  *		For use by MemoryContextMethods implementations to handle invalid
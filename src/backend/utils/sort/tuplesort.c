@@ -619,6 +619,192 @@ qsort_tuple_int32_compare(SortTuple *a, SortTuple *b, Tuplesortstate *state)
 #define ST_DEFINE
 #include "lib/sort_template.h"
 
+/*
+ * Radix sort for SortTuples whose leading datum1 is compared by one of the
+ * ssup_datum_{unsigned,signed,int32}_cmp comparators.
+ *
+ * datum1 is mapped to an unsigned key whose byte-wise order matches the
+ * comparator's ordering (including ssup_reverse), and the tuples are then
+ * sorted by an in-place MSD radix sort ("American flag sort") on those
+ * bytes.  Partitions smaller than RADIX_SORT_THRESHOLD are handed to the
+ * corresponding specialized qsort, which then only has to order a few
+ * tuples whose leading bytes already agree.  Groups whose keys are equal in
+ * all bytes still need to be ordered by any remaining sort keys, or by the
+ * full value if datum1 is an abbreviation; that's left to
+ * comparetup_tiebreak, unless datum1 is the only key.
+ *
+ * NULLs in datum1 are separated out first, and likewise treated as one
+ * group for tie-breaking.
+ */
+#define RADIX_SORT_THRESHOLD	64
+
+typedef void (*radix_fallback_sort) (SortTuple *data, size_t n,
+									 Tuplesortstate *state);
+
+typedef enum
+{
+	RADIX_KEY_UNSIGNED,
+	RADIX_KEY_SIGNED,
+	RADIX_KEY_INT32,
+} RadixKeyKind;
+
+static pg_attribute_always_inline uint64
+radix_sort_key(Datum datum, RadixKeyKind kind, bool reverse)
+{
+	uint64		key;
+
+	switch (kind)
+	{
+		case RADIX_KEY_SIGNED:
+			key = (uint64) datum ^ (UINT64CONST(1) << 63);
+			break;
+		case RADIX_KEY_INT32:
+			key = (uint32) DatumGetInt32(datum) ^ ((uint32) 1 << 31);
+			if (reverse)
+				return (uint32) ~key;
+			return key;
+		default:
+			key = (uint64) datum;
+			break;
+	}
+
+	return reverse ? ~key : key;
+}
+
+static void
+radix_sort_ties(SortTuple *data, size_t n, Tuplesortstate *state)
+{
+	if (n > 1 && state->base.onlyKey == NULL)
+		qsort_tuple(data, n, state->base.comparetup_tiebreak, state);
+}
+
+static void
+radix_sort_recurse(SortTuple *data, size_t n, int byte, RadixKeyKind kind,
+				   radix_fallback_sort fallback, Tuplesortstate *state)
+{
+	bool		reverse = state->base.sortKeys[0].ssup_reverse;
+	size_t		counts[256];
+	size_t		heads[256];
+	size_t		tails[256];
+	int			shift;
+
+	CHECK_FOR_INTERRUPTS();
+
+	/* skip over bytes for which all the keys have the same value */
+	for (;;)
+	{
+		shift = (7 - byte) * 8;
+
+		memset(counts, 0, sizeof(counts));
+		for (size_t i = 0; i < n; i++)
+			counts[(radix_sort_key(data[i].datum1, kind, reverse) >> shift) & 0xFF]++;
+
+		if (counts[(radix_sort_key(data[0].datum1, kind, reverse) >> shift) & 0xFF] != n)
+			break;
+
+		if (byte == 7)
+		{
+			radix_sort_ties(data, n, state);
+			return;
+		}
+		byte++;
+	}
+
+	/* compute the bucket boundaries */
+	heads[0] = 0;
+	for (int b = 1; b < 256; b++)
+		heads[b] = heads[b - 1] + counts[b - 1];
+	for (int b = 0; b < 256; b++)
+		tails[b] = heads[b] + counts[b];
+
+	/* permute the tuples into their buckets, in place */
+	for (int b = 0; b < 256; b++)
+	{
+		while (heads[b] < tails[b])
+		{
+			SortTuple  *cur = &data[heads[b]];
+			int			d = (radix_sort_key(cur->datum1, kind, reverse) >> shift) & 0xFF;
+
+			if (d == b)
+				heads[b]++;
+			else
+			{
+				SortTuple	tmp = data[heads[d]];
+
+				data[heads[d]++] = *cur;
+				*cur = tmp;
+			}
+		}
+	}
+
+	/* now heads[b] is the end of bucket b; sort each bucket by later bytes */
+	for (int b = 0; b < 256; b++)
+	{
+		size_t		start = heads[b] - counts[b];
+
+		if (counts[b] <= 1)
+			continue;
+		if (counts[b] < RADIX_SORT_THRESHOLD)
+			fallback(&data[start], counts[b], state);
+		else if (byte == 7)
+			radix_sort_ties(&data[start], counts[b], state);
+		else
+			radix_sort_recurse(&data[start], counts[b], byte + 1, kind,
+							   fallback, state);
+	}
+}
+
+static void
+radix_sort_tuple(SortTuple *data, size_t n, RadixKeyKind kind,
+				 radix_fallback_sort fallback, Tuplesortstate *state)
+{
+	bool		nulls_first = state->base.sortKeys[0].ssup_nulls_first;
+	size_t		nnulls = 0;
+	SortTuple  *notnull;
+
+	/* move NULLs to the front or back, as required */
+	if (nulls_first)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			if (data[i].isnull1)
+			{
+				SortTuple	tmp = data[nnulls];
+
+				data[nnulls++] = data[i];
+				data[i] = tmp;
+			}
+		}
+		radix_sort_ties(data, nnulls, state);
+		notnull = data + nnulls;
+	}
+	else
+	{
+		size_t		end = n;
+
+		for (size_t i = n; i-- > 0;)
+		{
+			if (data[i].isnull1)
+			{
+				SortTuple	tmp = data[--end];
+
+				data[end] = data[i];
+				data[i] = tmp;
+			}
+		}
+		nnulls = n - end;
+		radix_sort_ties(data + end, nnulls, state);
+		notnull = data;
+	}
+
+	if (n - nnulls < RADIX_SORT_THRESHOLD)
+		fallback(notnull, n - nnulls, state);
+	else
+		radix_sort_recurse(notnull, n - nnulls,
+						   kind == RADIX_KEY_INT32 ? 4 : 8 - SIZEOF_DATUM,
+						   kind, fallback, state);
+}
+
 /*
  *		tuplesort_begin_xxx
  *
@@ -2685,27 +2871,48 @@ tuplesort_sort_memtuples(Tuplesortstate *state)
 		 */
 		if (state->base.haveDatum1 && state->base.sortKeys)
 		{
+			/*
+			 * For larger inputs, a radix sort on datum1 beats comparison
+			 * sorting; small inputs aren't worth the counting passes.
+			 */
+			bool		radix = state->memtupcount >= RADIX_SORT_THRESHOLD * 4;
+
 			if (state->base.sortKeys[0].comparator == ssup_datum_unsigned_cmp)
 			{
-				qsort_tuple_unsigned(state->memtuples,
-									 state->memtupcount,
-									 state);
+				if (radix)
+					radix_sort_tuple(state->memtuples, state->memtupcount,
+									 RADIX_KEY_UNSIGNED,
+									 qsort_tuple_unsigned, state);
+				else
+					qsort_tuple_unsigned(state->memtuples,
+										 state->memtupcount,
+										 state);
 				return;
 			}
 #if SIZEOF_DATUM >= 8
 			else if (state->base.sortKeys[0].comparator == ssup_datum_signed_cmp)
 			{
-				qsort_tuple_signed(state->memtuples,
-								   state->memtupcount,
-								   state);
+				if (radix)
+					radix_sort_tuple(state->memtuples, state->memtupcount,
+									 RADIX_KEY_SIGNED,
+									 qsort_tuple_signed, state);
+				else
+					qsort_tuple_signed(state->memtuples,
+									   state->memtupcount,
+									   state);
 				return;
 			}
 #endif
 			else if (state->base.sortKeys[0].comparator == ssup_datum_int32_cmp)
 			{
-				qsort_tuple_int32(state->memtuples,
-								  state->memtupcount,
-								  state);
+				if (radix)
+					radix_sort_tuple(state->memtuples, state->memtupcount,
+									 RADIX_KEY_INT32,
+									 qsort_tuple_int32, state);
+				else
+					qsort_tuple_int32(state->memtuples,
+									  state->memtupcount,
+									  state);
 				return;
 			}
 		}
@@ -22,6 +22,12 @@
 #include "reconstruct.h"
 #include "storage/block.h"
 
+/*
+ * Maximum number of blocks write_reconstructed_file() copies with a single
+ * read and write.
+ */
+#define RECONSTRUCT_RUN_BLOCKS	128
+
 /*
  * An rfile stores the data that we need in order to be able to use some file
  * on disk for reconstruction. For any given output file, we create one rfile
@@ -62,10 +68,10 @@ static void write_reconstructed_file(char *input_filename,
 									 bool debug,
 									 bool dry_run);
 static void read_bytes(rfile *rf, void *buffer, unsigned length);
-static void write_block(int fd, char *output_filename,
-						uint8 *buffer,
-						pg_checksum_context *checksum_ctx);
-static void read_block(rfile *s, off_t off, uint8 *buffer);
+static void write_blocks(int fd, char *output_filename,
+						 uint8 *buffer, size_t nbytes,
+						 pg_checksum_context *checksum_ctx);
+static void read_blocks(rfile *s, off_t off, uint8 *buffer, size_t nbytes);
 
 /*
  * Reconstruct a full file from an incremental file and a chain of prior
@@ -560,7 +566,9 @@ write_reconstructed_file(char *input_filename,
 {
 	int			wfd = -1;
 	unsigned	i;
+	unsigned	nblocks;
 	unsigned	zero_blocks = 0;
+	uint8	   *buffer = NULL;
 
 	/* Debugging output. */
 	if (debug)
@@ -637,51 +645,69 @@ write_reconstructed_file(char *input_filename,
 					pg_file_create_mode)) < 0)
 		pg_fatal("could not open file \"%s\": %m", output_filename);
 
-	/* Read and write the blocks as required. */
-	for (i = 0; i < block_length; ++i)
+	/* Allocate an I/O buffer big enough for the longest run we copy. */
+	if (!dry_run)
+		buffer = pg_malloc(RECONSTRUCT_RUN_BLOCKS * BLCKSZ);
+
+	/*
+	 * Read and write the blocks as required.  Consecutive blocks that come
+	 * from consecutive offsets of the same source file, or that are all to be
+	 * zero-filled, are handled as one run, so that we issue one large read
+	 * and write (or copy_file_range call) instead of one per block.
+	 */
+	for (i = 0; i < block_length; i += nblocks)
 	{
-		uint8		buffer[BLCKSZ];
 		rfile	   *s = sourcemap[i];
+		size_t		nbytes;
+
+		nblocks = 1;
+		while (i + nblocks < block_length &&
+			   nblocks < RECONSTRUCT_RUN_BLOCKS &&
+			   sourcemap[i + nblocks] == s &&
+			   (s == NULL ||
+				offsetmap[i + nblocks] == offsetmap[i] + (off_t) nblocks * BLCKSZ))
+			nblocks++;
+		nbytes = (size_t) nblocks * BLCKSZ;
 
 		/* Update accounting information. */
 		if (s == NULL)
-			++zero_blocks;
+			zero_blocks += nblocks;
 		else
 		{
-			s->num_blocks_read++;
+			s->num_blocks_read += nblocks;
 			s->highest_offset_read = Max(s->highest_offset_read,
-										 offsetmap[i] + BLCKSZ);
+										 offsetmap[i] + (off_t) nbytes);
 		}
 
 		/* Skip the rest of this in dry-run mode. */
 		if (dry_run)
 			continue;
 
-		/* Read or zero-fill the block as appropriate. */
+		/* Read or zero-fill the blocks as appropriate. */
 		if (s == NULL)
 		{
 			/*
-			 * New block not mentioned in the WAL summary. Should have been an
-			 * uninitialized block, so just zero-fill it.
+			 * New blocks not mentioned in the WAL summary. Should have been
+			 * uninitialized blocks, so just zero-fill them.
 			 */
-			memset(buffer, 0, BLCKSZ);
+			memset(buffer, 0, nbytes);
 
-			/* Write out the block, update the checksum if needed. */
-			write_block(wfd, output_filename, buffer, checksum_ctx);
+			/* Write out the blocks, update the checksum if needed. */
+			write_blocks(wfd, output_filename, buffer, nbytes, checksum_ctx);
 
 			/* Nothing else to do for zero-filled blocks. */
 			continue;
 		}
 
-		/* Copy the block using the appropriate copy method. */
+		/* Copy the blocks using the appropriate copy method. */
 		if (copy_method != COPY_METHOD_COPY_FILE_RANGE)
 		{
 			/*
-			 * Read the block from the correct source file, and then write it
-			 * out, possibly with a checksum update.
+			 * Read the blocks from the correct source file, and then write
+			 * them out, possibly with a checksum update.
 			 */
-			read_block(s, offsetmap[i], buffer);
-			write_block(wfd, output_filename, buffer, checksum_ctx);
+			read_blocks(s, offsetmap[i], buffer, nbytes);
+			write_blocks(wfd, output_filename, buffer, nbytes, checksum_ctx);
 		}
 		else					/* use copy_file_range */
 		{
@@ -696,9 +722,9 @@ write_reconstructed_file(char *input_filename,
 			 */
 			do
 			{
-				int			wb;
+				ssize_t		wb;
 
-				wb = copy_file_range(s->fd, &off, wfd, NULL, BLCKSZ - nwritten, 0);
+				wb = copy_file_range(s->fd, &off, wfd, NULL, nbytes - nwritten, 0);
 
 				if (wb < 0)
 					pg_fatal("error while copying file range from \"%s\" to \"%s\": %m",
@@ -706,18 +732,18 @@ write_reconstructed_file(char *input_filename,
 
 				nwritten += wb;
 
-			} while (BLCKSZ > nwritten);
+			} while (nbytes > nwritten);
 
 			/*
 			 * When checksum calculation not needed, we're done, otherwise
-			 * read the block and pass it to the checksum calculation.
+			 * read the blocks and pass them to the checksum calculation.
 			 */
 			if (checksum_ctx->type == CHECKSUM_TYPE_NONE)
 				continue;
 
-			read_block(s, offsetmap[i], buffer);
+			read_blocks(s, offsetmap[i], buffer, nbytes);
 
-			if (pg_checksum_update(checksum_ctx, buffer, BLCKSZ) < 0)
+			if (pg_checksum_update(checksum_ctx, buffer, nbytes) < 0)
 				pg_fatal("could not update checksum of file \"%s\"",
 						 output_filename);
 #else
@@ -726,6 +752,9 @@ write_reconstructed_file(char *input_filename,
 		}
 	}
 
+	if (buffer != NULL)
+		pfree(buffer);
+
 	/* Debugging output. */
 	if (zero_blocks > 0)
 	{
@@ -741,49 +770,48 @@ write_reconstructed_file(char *input_filename,
 }
 
 /*
- * Write the block into the file (using the file descriptor), and
- * if needed update the checksum calculation.
+ * Write nbytes of data, a whole number of blocks, into the file (using the
+ * file descriptor), and if needed update the checksum calculation.
  *
- * The buffer is expected to contain BLCKSZ bytes. The filename is
- * provided only for the error message.
+ * The filename is provided only for the error message.
  */
 static void
-write_block(int fd, char *output_filename,
-			uint8 *buffer, pg_checksum_context *checksum_ctx)
+write_blocks(int fd, char *output_filename,
+			 uint8 *buffer, size_t nbytes,
+			 pg_checksum_context *checksum_ctx)
 {
-	int			wb;
+	ssize_t		wb;
 
-	if ((wb = write(fd, buffer, BLCKSZ)) != BLCKSZ)
+	if ((wb = write(fd, buffer, nbytes)) != (ssize_t) nbytes)
 	{
 		if (wb < 0)
 			pg_fatal("could not write file \"%s\": %m", output_filename);
 		else
-			pg_fatal("could not write file \"%s\": wrote %d of %d",
-					 output_filename, wb, BLCKSZ);
+			pg_fatal("could not write file \"%s\": wrote %zd of %zu",
+					 output_filename, wb, nbytes);
 	}
 
 	/* Update the checksum computation. */
-	if (pg_checksum_update(checksum_ctx, buffer, BLCKSZ) < 0)
+	if (pg_checksum_update(checksum_ctx, buffer, nbytes) < 0)
 		pg_fatal("could not update checksum of file \"%s\"",
 				 output_filename);
 }
 
 /*
- * Read a block of data (BLCKSZ bytes) into the buffer.
+ * Read nbytes of data, a whole number of blocks, into the buffer.
  */
 static void
-read_block(rfile *s, off_t off, uint8 *buffer)
+read_blocks(rfile *s, off_t off, uint8 *buffer, size_t nbytes)
 {
-	int			rb;
+	ssize_t		rb;
 
-	/* Read the block from the correct source, except if dry-run. */
-	rb = pg_pread(s->fd, buffer, BLCKSZ, off);
-	if (rb != BLCKSZ)
+	rb = pg_pread(s->fd, buffer, nbytes, off);
+	if (rb != (ssize_t) nbytes)
 	{
 		if (rb < 0)
 			pg_fatal("could not read from file \"%s\": %m", s->filename);
 		else
-			pg_fatal("could not read from file \"%s\", offset %llu: read %d of %d",
-					 s->filename, (unsigned long long) off, rb, BLCKSZ);
+			pg_fatal("could not read from file \"%s\", offset %llu: read %zd of %zu",
+					 s->filename, (unsigned long long) off, rb, nbytes);
 	}
 }
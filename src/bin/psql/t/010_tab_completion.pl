@@ -423,6 +423,14 @@ check_completion(
 
 clear_line();
 
+# check index storage parameter completion
+check_completion(
+	"ALTER INDEX foo SET (autoc\t",
+	qr/autocleanup = /,
+	"complete GIN autocleanup storage parameter");
+
+clear_line();
+
 # send psql an explicit \q to shut it down, else pty won't close properly
 $h->quit or die "psql returned $?";
 
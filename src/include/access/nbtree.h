@@ -1071,6 +1071,22 @@ typedef struct BTScanOpaqueData
 	int		   *killedItems;	/* currPos.items indexes of killed items */
 	int			numKilled;		/* number of currently stored items */
 	bool		dropPin;		/* drop leaf pin before btgettuple returns? */
+	BlockNumber lastLeaf;		/* leaf page most recently read, if any */
+	int			lastLeafMisses; /* consecutive failed attempts to start a
+								 * search at lastLeaf */
+
+	/*
+	 * State for prefetching the heap blocks of the TIDs on the current leaf
+	 * page ahead of the scan (see _bt_prefetch_heap).  prefetchMaximum is 0
+	 * when prefetching is disabled, e.g. during bitmap index scans, and -1
+	 * until it has been looked up on first use.
+	 */
+	int			prefetchMaximum;	/* maximum look-ahead distance, in items */
+	int			prefetchDistance;	/* current look-ahead distance */
+	int			prefetchItem;	/* next currPos.items[] index to consider */
+	BlockNumber prefetchPage;	/* leaf page that prefetchItem refers to */
+	BlockNumber prefetchBlock;	/* heap block last prefetched */
+	Buffer		prefetchVmBuffer;	/* VM buffer, for index-only scans */
 
 	/*
 	 * If we are doing an index-only scan, these are the tuple storage
@@ -59,6 +59,9 @@ extern PGDLLIMPORT int wal_decode_buffer_size;
 
 extern PGDLLIMPORT int CheckPointSegments;
 
+/* upper limit for commit_delay, also applied to the adaptive delay */
+#define MAX_COMMIT_DELAY	100000
+
 /* Archive modes */
 typedef enum ArchiveMode
 {
@@ -287,6 +287,8 @@ typedef enum ExprEvalOp
 	EEOP_AGG_PLAIN_TRANS_INIT_STRICT_BYREF,
 	EEOP_AGG_PLAIN_TRANS_STRICT_BYREF,
 	EEOP_AGG_PLAIN_TRANS_BYREF,
+	EEOP_AGG_PLAIN_TRANS_INT8INC,
+	EEOP_AGG_PLAIN_TRANS_INT4_SUM,
 	EEOP_AGG_PRESORTED_DISTINCT_SINGLE,
 	EEOP_AGG_PRESORTED_DISTINCT_MULTI,
 	EEOP_AGG_ORDERED_TRANS_DATUM,
@@ -734,6 +736,7 @@ typedef struct ExprEvalStep
 		}			agg_presorted_distinctcheck;
 
 		/* for EEOP_AGG_PLAIN_TRANS_[INIT_][STRICT_]{BYVAL,BYREF} */
+		/* for EEOP_AGG_PLAIN_TRANS_{INT8INC,INT4_SUM} */
 		/* for EEOP_AGG_ORDERED_TRANS_{DATUM,TUPLE} */
 		struct
 		{
@@ -56,6 +56,19 @@ typedef struct WalUsage
 	int64		wal_buffers_full;	/* # of times the WAL buffers became full */
 } WalUsage;
 
+/*
+ * CpuUsage holds readings of the hardware performance counters, counting
+ * user-space activity of the current process only.  Like BufferUsage, the
+ * counters only ever increase, and callers work with differences.
+ */
+typedef struct CpuUsage
+{
+	int64		cycles;			/* # of CPU cycles */
+	int64		instructions;	/* # of instructions retired */
+	int64		cache_misses;	/* # of last-level cache misses */
+	int64		branch_misses;	/* # of mispredicted branches */
+} CpuUsage;
+
 /* Flag bits included in InstrAlloc's instrument_options bitmask */
 typedef enum InstrumentOption
 {
@@ -63,6 +76,7 @@ typedef enum InstrumentOption
 	INSTRUMENT_BUFFERS = 1 << 1,	/* needs buffer usage */
 	INSTRUMENT_ROWS = 1 << 2,	/* needs row count */
 	INSTRUMENT_WAL = 1 << 3,	/* needs WAL usage */
+	INSTRUMENT_CPU = 1 << 4,	/* needs hardware counter readings */
 	INSTRUMENT_ALL = PG_INT32_MAX
 } InstrumentOption;
 
@@ -72,6 +86,7 @@ typedef struct Instrumentation
 	bool		need_timer;		/* true if we need timer data */
 	bool		need_bufusage;	/* true if we need buffer usage data */
 	bool		need_walusage;	/* true if we need WAL usage data */
+	bool		need_cpuusage;	/* true if we need hardware counter data */
 	bool		async_mode;		/* true if node is in async mode */
 	/* Info about current plan cycle: */
 	bool		running;		/* true if we've completed first tuple */
@@ -81,6 +96,7 @@ typedef struct Instrumentation
 	double		tuplecount;		/* # of tuples emitted so far this cycle */
 	BufferUsage bufusage_start; /* buffer usage at start */
 	WalUsage	walusage_start; /* WAL usage at start */
+	CpuUsage	cpuusage_start; /* hardware counters at start */
 	/* Accumulated statistics across all completed cycles: */
 	double		startup;		/* total startup time (in seconds) */
 	double		total;			/* total time (in seconds) */
@@ -91,6 +107,7 @@ typedef struct Instrumentation
 	double		nfiltered2;		/* # of tuples removed by "other" quals */
 	BufferUsage bufusage;		/* total buffer usage */
 	WalUsage	walusage;		/* total WAL usage */
+	CpuUsage	cpuusage;		/* total hardware counter deltas */
 } Instrumentation;
 
 typedef struct WorkerInstrumentation
@@ -117,5 +134,6 @@ extern void BufferUsageAccumDiff(BufferUsage *dst,
 								 const BufferUsage *add, const BufferUsage *sub);
 extern void WalUsageAccumDiff(WalUsage *dst, const WalUsage *add,
 							  const WalUsage *sub);
+extern bool InstrCpuUsageAvailable(void);
 
 #endif							/* INSTRUMENT_H */
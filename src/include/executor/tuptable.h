@@ -128,6 +128,8 @@ typedef struct TupleTableSlot
 	MemoryContext tts_mcxt;		/* slot itself is in this context */
 	ItemPointerData tts_tid;	/* stored tuple's tid */
 	Oid			tts_tableOid;	/* table oid of tuple */
+	AttrNumber	tts_nfixed;		/* # of leading attributes at fixed offsets,
+								 * or -1 if not computed yet */
 } TupleTableSlot;
 
 /* routines for a TupleTableSlot implementation */
@@ -2496,6 +2496,7 @@ typedef struct AggregateInstrumentation
 	Size		hash_mem_peak;	/* peak hash table memory usage */
 	uint64		hash_disk_used; /* kB of disk space used */
 	int			hash_batches_used;	/* batches used during entire execution */
+	int			hash_flushes;	/* partial flushes during entire execution */
 } AggregateInstrumentation;
 
 /* ----------------
@@ -2582,6 +2583,10 @@ typedef struct AggState
 	bool		hash_ever_spilled;	/* ever spilled during this execution? */
 	bool		hash_spill_mode;	/* we hit a limit during the current batch
 									 * and we must not create new groups */
+	bool		hash_partial_flush; /* emit partial groups rather than spill? */
+	bool		hash_flush_pending; /* hit a limit; emit and reset the table
+									 * before reading more input */
+	bool		hash_ever_flushed;	/* ever flushed during this execution? */
 	Size		hash_mem_limit; /* limit before spilling hash table */
 	uint64		hash_ngroups_limit; /* limit before spilling hash table */
 	int			hash_planned_partitions;	/* number of partitions planned
@@ -2592,6 +2597,7 @@ typedef struct AggState
 										 * memory in all hash tables */
 	uint64		hash_disk_used; /* kB of disk space used */
 	int			hash_batches_used;	/* batches used during entire execution */
+	int			hash_flushes;	/* partial flushes during entire execution */
 
 	AggStatePerHash perhash;	/* array of per-hashtable data */
 	AggStatePerGroup *hash_pergroup;	/* grouping set indexed array of
@@ -23,6 +23,7 @@
 typedef enum
 {
 	AVW_BRINSummarizeRange,
+	AVW_GINCleanPendingList,
 } AutoVacuumWorkItemType;
 
 
@@ -39,6 +40,7 @@ extern PGDLLIMPORT int autovacuum_vac_ins_thresh;
 extern PGDLLIMPORT double autovacuum_vac_ins_scale;
 extern PGDLLIMPORT int autovacuum_anl_thresh;
 extern PGDLLIMPORT double autovacuum_anl_scale;
+extern PGDLLIMPORT double autovacuum_freeze_debt_scale;
 extern PGDLLIMPORT int autovacuum_freeze_max_age;
 extern PGDLLIMPORT int autovacuum_multixact_freeze_max_age;
 extern PGDLLIMPORT double autovacuum_vac_cost_delay;
@@ -448,7 +448,11 @@ extern void StrategyFreeBuffer(BufferDesc *buf);
 extern bool StrategyRejectBuffer(BufferAccessStrategy strategy,
 								 BufferDesc *buf, bool from_ring);
 
-extern int	StrategySyncStart(uint32 *complete_passes, uint32 *num_buf_alloc);
+extern int	StrategyNumPartitions(void);
+extern void StrategyPartitionRange(int partition, int *first_buffer,
+								   int *num_buffers);
+extern int	StrategySyncStart(int partition, uint32 *complete_passes,
+							  uint32 *num_buf_alloc);
 extern void StrategyNotifyBgWriter(int bgwprocno);
 
 extern Size StrategyShmemSize(void);
@@ -141,8 +141,11 @@ do { \
 /*
  * Block checksum algorithm.  The page must be adequately aligned
  * (at least on 4-byte boundary).
+ *
+ * This is always inlined so that a caller compiled for a wider instruction
+ * set (see PG_CHECKSUM_BLOCK below) gets a copy vectorized to match.
  */
-static uint32
+static pg_attribute_always_inline uint32
 pg_checksum_block(const PGChecksummablePage *page)
 {
 	uint32		sums[N_SUMS];
@@ -173,6 +176,18 @@ pg_checksum_block(const PGChecksummablePage *page)
 	return result;
 }
 
+/*
+ * An includer may define PG_CHECKSUM_BLOCK as the name of its own block
+ * checksum function, for instance one that picks a CPU-specific build of
+ * pg_checksum_block() at runtime.  It must return exactly what
+ * pg_checksum_block() would.
+ */
+#ifdef PG_CHECKSUM_BLOCK
+static uint32 PG_CHECKSUM_BLOCK(const PGChecksummablePage *page);
+#else
+#define PG_CHECKSUM_BLOCK pg_checksum_block
+#endif
+
 /*
  * Compute the checksum for a Postgres page.
  *
@@ -201,7 +216,7 @@ pg_checksum_page(char *page, BlockNumber blkno)
 	 */
 	save_checksum = cpage->phdr.pd_checksum;
 	cpage->phdr.pd_checksum = 0;
-	checksum = pg_checksum_block(cpage);
+	checksum = PG_CHECKSUM_BLOCK(cpage);
 	cpage->phdr.pd_checksum = save_checksum;
 
 	/* Mix in the block number to detect transposed pages */
@@ -312,6 +312,8 @@ extern int	ParseDateTime(const char *timestr, char *workbuf, size_t buflen,
 extern int	DecodeDateTime(char **field, int *ftype, int nf,
 						   int *dtype, struct pg_tm *tm, fsec_t *fsec, int *tzp,
 						   DateTimeErrorExtra *extra);
+extern bool DecodeISODateTimeFast(const char *str, bool allow_time,
+								  struct pg_tm *tm, fsec_t *fsec);
 extern int	DecodeTimezone(const char *str, int *tzp);
 extern int	DecodeTimeOnly(char **field, int *ftype, int nf,
 						   int *dtype, struct pg_tm *tm, fsec_t *fsec, int *tzp,
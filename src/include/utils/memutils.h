@@ -66,6 +66,9 @@ extern PGDLLIMPORT MemoryContext CurTransactionContext;
 /* This is a transient link to the active portal's memory context: */
 extern PGDLLIMPORT MemoryContext PortalContext;
 
+/* GUC: request transparent huge pages for large blocks */
+extern PGDLLIMPORT bool backend_huge_pages;
+
 
 /*
  * Memory-context-type-independent functions in mcxt.c
@@ -160,6 +160,27 @@ extern void MemoryContextCreate(MemoryContext node,
 extern void *MemoryContextAllocationFailure(MemoryContext context, Size size,
 											int flags);
 
+/*
+ * Transparent huge page size assumed by MemoryContextAdviseHugePages().  This
+ * is 2MB on common platforms; elsewhere the advice is merely less effective.
+ */
+#define MEMORY_CONTEXT_HUGE_PAGE_SIZE	((Size) 2 * 1024 * 1024)
+
+extern void MemoryContextAdviseHugePagesInternal(void *block, Size size);
+
+/*
+ * For use by MemoryContextMethods implementations after malloc'ing a new
+ * block.  If backend_huge_pages is on, and the block is large enough to be
+ * sure to contain a whole huge page, advise the kernel to use huge pages.
+ */
+static inline void
+MemoryContextAdviseHugePages(void *block, Size size)
+{
+	if (unlikely(backend_huge_pages) &&
+		size >= 2 * MEMORY_CONTEXT_HUGE_PAGE_SIZE)
+		MemoryContextAdviseHugePagesInternal(block, size);
+}
+
 pg_noreturn extern void MemoryContextSizeFailure(MemoryContext context, Size size,
 												 int flags);
 
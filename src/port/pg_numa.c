@@ -29,6 +29,7 @@
 
 #include <numa.h>
 #include <numaif.h>
+#include <sched.h>
 
 /*
  * numa_move_pages() chunk size, has to be <= 16 to work around a kernel bug
@@ -106,6 +107,22 @@ pg_numa_get_max_node(void)
 	return numa_max_node();
 }
 
+/*
+ * Return the NUMA node of the CPU the calling process is currently running
+ * on, or -1 if that can't be determined.  The process may of course be
+ * migrated to another node at any time, so the result is only a hint.
+ */
+int
+pg_numa_get_current_node(void)
+{
+	int			cpu = sched_getcpu();
+
+	if (cpu < 0)
+		return -1;
+
+	return numa_node_of_cpu(cpu);
+}
+
 #else
 
 /* Empty wrappers */
@@ -128,4 +145,10 @@ pg_numa_get_max_node(void)
 	return 0;
 }
 
+int
+pg_numa_get_current_node(void)
+{
+	return -1;
+}
+
 #endif
@@ -0,0 +1,132 @@
+# Copyright (c) 2025, PostgreSQL Global Development Group
+
+# Test that autovacuum_freeze_debt_scale_factor triggers an autovacuum of a
+# table with many all-visible but not all-frozen pages, and that it stops
+# triggering once that vacuum has paid down enough of the debt.  Also test
+# that an autovacuum that could not freeze anything, because an old
+# transaction held back the freeze cutoff, does not disarm the trigger for
+# good.
+
+use strict;
+use warnings FATAL => 'all';
+use PostgreSQL::Test::Cluster;
+use PostgreSQL::Test::Utils;
+use Test::More;
+
+my $node = PostgreSQL::Test::Cluster->new('main');
+$node->init;
+$node->append_conf(
+	'postgresql.conf', qq[
+autovacuum_naptime = 1s
+autovacuum_freeze_debt_scale_factor = 0.9
+log_autovacuum_min_duration = 0
+]);
+$node->start;
+
+# Build a table of more than two eager scan regions (8192 pages), with one
+# row per page, and make all of it all-visible but not all-frozen.
+$node->safe_psql(
+	'postgres', qq[
+CREATE TABLE debt (id int, filler text)
+  WITH (fillfactor = 10, autovacuum_enabled = off);
+INSERT INTO debt SELECT i, repeat(md5(i::text), 22)
+  FROM generate_series(1, 8300) i;
+VACUUM (ANALYZE) debt;
+]);
+
+my $result = $node->safe_psql('postgres',
+	"SELECT relpages >= 8192, relallvisible = relpages, relallfrozen = 0
+	 FROM pg_class WHERE relname = 'debt'");
+is($result, "t|t|t", 'table is all-visible but not frozen');
+
+# Make relfrozenxid older than the freeze cutoff, then let autovacuum at it.
+$node->safe_psql(
+	'postgres', qq[
+SELECT pg_current_xact_id();
+ALTER TABLE debt SET (autovacuum_enabled = on, autovacuum_freeze_min_age = 0);
+]);
+
+$node->poll_query_until('postgres',
+	"SELECT autovacuum_count > 0 FROM pg_stat_user_tables WHERE relname = 'debt'"
+) or die "timed out waiting for freeze debt autovacuum";
+
+$result = $node->safe_psql('postgres',
+	"SELECT relallfrozen > 0 FROM pg_class WHERE relname = 'debt'");
+is($result, "t", 'autovacuum froze some of the debt');
+
+# Eager scanning freezes at most a fifth of the debt per vacuum, which is
+# enough to bring it under the threshold.  Let autovacuum process the
+# database a couple more times, using a second table to see that it did, and
+# check that the first table was not vacuumed again.
+$node->safe_psql(
+	'postgres', qq[
+CREATE TABLE marker (id int);
+INSERT INTO marker SELECT generate_series(1, 1000);
+]);
+for my $pass (1 .. 2)
+{
+	$node->safe_psql('postgres', "DELETE FROM marker WHERE id % 2 = $pass % 2");
+	$node->safe_psql('postgres', "INSERT INTO marker SELECT generate_series(1, 500)");
+	$node->poll_query_until('postgres',
+		"SELECT autovacuum_count >= $pass FROM pg_stat_user_tables WHERE relname = 'marker'"
+	) or die "timed out waiting for autovacuum of marker table";
+}
+
+$result = $node->safe_psql('postgres',
+	"SELECT autovacuum_count FROM pg_stat_user_tables WHERE relname = 'debt'");
+is($result, "1", 'freeze debt triggered only one autovacuum');
+
+# Now build a second table with freeze debt, and open a transaction that
+# keeps OldestXmin from advancing.
+$node->safe_psql(
+	'postgres', qq[
+CREATE TABLE stuck (id int, filler text)
+  WITH (fillfactor = 10, autovacuum_enabled = off);
+INSERT INTO stuck SELECT i, repeat(md5(i::text), 22)
+  FROM generate_series(1, 8300) i;
+VACUUM stuck;
+]);
+
+my $psql = $node->background_psql('postgres');
+$psql->query_safe("BEGIN; SELECT pg_current_xact_id();");
+
+# Consume enough XIDs for relfrozenxid to look older than a freeze_min_age
+# of 1000, while the freeze cutoff the vacuum actually computes stays held
+# back by the open transaction, so the vacuum freezes nothing.
+$node->safe_psql(
+	'postgres', qq[
+DO \$\$
+BEGIN
+  FOR i IN 1..1100 LOOP
+    PERFORM pg_current_xact_id();
+    COMMIT;
+  END LOOP;
+END
+\$\$;
+ALTER TABLE stuck SET (autovacuum_enabled = on, autovacuum_freeze_min_age = 1000);
+]);
+
+$node->poll_query_until('postgres',
+	"SELECT autovacuum_count > 0 FROM pg_stat_user_tables WHERE relname = 'stuck'"
+) or die "timed out waiting for futile freeze debt autovacuum";
+
+$result = $node->safe_psql('postgres',
+	"SELECT relallfrozen FROM pg_class WHERE relname = 'stuck'");
+is($result, "0", 'autovacuum held back by old transaction froze nothing');
+
+# Once the transaction is gone, the trigger must fire again after the
+# back-off period and this time make progress.
+$psql->query_safe("COMMIT;");
+$psql->quit;
+
+$node->poll_query_until('postgres',
+	"SELECT autovacuum_count > 1 FROM pg_stat_user_tables WHERE relname = 'stuck'"
+) or die "timed out waiting for freeze debt autovacuum to retry";
+
+$result = $node->safe_psql('postgres',
+	"SELECT relallfrozen > 0 FROM pg_class WHERE relname = 'stuck'");
+is($result, "t", 'autovacuum retried after a futile run and froze some debt');
+
+$node->stop;
+
+done_testing();
@@ -1615,6 +1615,28 @@ create table agg_hash_4 as
 select (g/2)::numeric as c1, array_agg(g::numeric) as c2, count(*) as c3
   from agg_data_2k group by g/2;
 
+-- A partial hash aggregate emits its groups and starts over, rather than
+-- spilling, when it runs out of memory; the Finalize Aggregate combines
+-- the duplicate groups this produces.
+
+set parallel_setup_cost = 0;
+set parallel_tuple_cost = 0;
+set min_parallel_table_scan_size = 0;
+set max_parallel_workers_per_gather = 2;
+
+explain (costs off)
+select g%10000 as c1, sum(g::numeric) as c2, count(*) as c3
+  from agg_data_20k group by g%10000;
+
+create table agg_hash_5 as
+select g%10000 as c1, sum(g::numeric) as c2, count(*) as c3
+  from agg_data_20k group by g%10000;
+
+reset parallel_setup_cost;
+reset parallel_tuple_cost;
+reset min_parallel_table_scan_size;
+reset max_parallel_workers_per_gather;
+
 set enable_sort = true;
 set work_mem to default;
 
@@ -1636,6 +1658,10 @@ set work_mem to default;
   union all
 (select * from agg_group_4 except select * from agg_hash_4);
 
+(select * from agg_hash_5 except select * from agg_group_1)
+  union all
+(select * from agg_group_1 except select * from agg_hash_5);
+
 drop table agg_group_1;
 drop table agg_group_2;
 drop table agg_group_3;
@@ -1644,3 +1670,4 @@ drop table agg_hash_1;
 drop table agg_hash_2;
 drop table agg_hash_3;
 drop table agg_hash_4;
+drop table agg_hash_5;
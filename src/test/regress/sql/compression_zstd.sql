@@ -0,0 +1,49 @@
+-- Tests for the zstd TOAST compression method; skipped if the server was
+-- built without zstd support.
+SELECT NOT ('zstd' = ANY (enumvals)) AS skip_test
+  FROM pg_settings WHERE name = 'default_toast_compression' \gset
+\if :skip_test
+\quit
+\endif
+
+-- ensure we get stable results regardless of installation's default
+SET default_toast_compression = 'pglz';
+
+CREATE OR REPLACE FUNCTION large_val_zstd() RETURNS TEXT LANGUAGE SQL AS
+'select array_agg(fipshash(g::text))::text from generate_series(1, 256) g';
+
+-- inline and externally stored compressed data
+CREATE TABLE cmzstd(id int, f1 text COMPRESSION zstd);
+INSERT INTO cmzstd VALUES (1, repeat('1234567890', 1004));
+INSERT INTO cmzstd VALUES (2, large_val_zstd() || repeat('a', 4000));
+SELECT id, pg_column_compression(f1) FROM cmzstd ORDER BY id;
+
+-- round trip
+SELECT id, length(f1) FROM cmzstd ORDER BY id;
+SELECT count(*) FROM cmzstd
+  WHERE f1 IN (repeat('1234567890', 1004), large_val_zstd() || repeat('a', 4000));
+
+-- decompress data slice
+SELECT SUBSTR(f1, 2000, 50) FROM cmzstd WHERE id = 1;
+SELECT SUBSTR(f1, 200, 50) = SUBSTR(large_val_zstd(), 200, 50) FROM cmzstd WHERE id = 2;
+SELECT SUBSTR(f1, 12000, 10) FROM cmzstd WHERE id = 2;
+
+-- test alter compression method; existing data keeps its method
+CREATE TABLE cmzstd2(id int, f1 text COMPRESSION pglz);
+INSERT INTO cmzstd2 VALUES (1, repeat('1234567890', 1004));
+ALTER TABLE cmzstd2 ALTER COLUMN f1 SET COMPRESSION zstd;
+INSERT INTO cmzstd2 VALUES (2, repeat('1234567890', 1004));
+SELECT id, pg_column_compression(f1) FROM cmzstd2 ORDER BY id;
+ALTER TABLE cmzstd2 ALTER COLUMN f1 SET COMPRESSION pglz;
+INSERT INTO cmzstd2 SELECT 3, f1 FROM cmzstd WHERE id = 1;
+SELECT id, pg_column_compression(f1) FROM cmzstd2 ORDER BY id;
+
+-- test default_toast_compression GUC
+SET default_toast_compression = 'zstd';
+CREATE TABLE cmzstd3(f1 text);
+INSERT INTO cmzstd3 VALUES (repeat('1234567890', 1004));
+SELECT pg_column_compression(f1) FROM cmzstd3;
+RESET default_toast_compression;
+
+DROP TABLE cmzstd, cmzstd2, cmzstd3;
+DROP FUNCTION large_val_zstd();
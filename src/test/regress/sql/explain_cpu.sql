@@ -0,0 +1,29 @@
+--
+-- EXPLAIN (CPU)
+--
+-- Whether hardware performance counters can be read depends on the platform
+-- and on kernel.perf_event_paranoid, so there's an alternate expected output
+-- for when they can't.
+--
+
+-- CPU requires ANALYZE, whether or not the counters are available
+explain (cpu) select 1;
+
+-- Return the names of the counters reported for a plan node
+create function explain_cpu_keys() returns setof text
+language plpgsql as
+$$
+declare
+    j json;
+begin
+    execute 'explain (analyze, cpu, format json) select 1' into j;
+    return query
+        select k from json_object_keys(j->0->'Plan') k where k like 'CPU %';
+end;
+$$;
+
+\set VERBOSITY terse
+select * from explain_cpu_keys();
+\set VERBOSITY default
+
+drop function explain_cpu_keys();
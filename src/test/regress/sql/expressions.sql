@@ -209,3 +209,28 @@ select * from inttest where a not in (1::myint,2::myint,3::myint,4::myint,5::myi
 select * from inttest where a not in (0::myint,2::myint,3::myint,4::myint,5::myint, null);
 
 rollback;
+
+--
+-- Test single "var op const" quals, which are evaluated by a fast path,
+-- on NULL and non-NULL column values
+--
+
+create temp table qual_fastpath (id int, v int4, t text);
+insert into qual_fastpath values
+  (1, 1, 'one'), (2, null, null), (3, 3, 'three'), (4, null, 'four'), (5, 5, null);
+
+select id from qual_fastpath where v < 4 order by id;
+select id from qual_fastpath where v >= 3 order by id;
+select id from qual_fastpath where 3 > v order by id;
+select id from qual_fastpath where t = 'three' order by id;
+select id from qual_fastpath where t <> 'three' order by id;
+select id from qual_fastpath where t like 'f%' order by id;
+
+-- a strict function can still return NULL, which counts as false
+create function qual_fastpath_odd(int4) returns bool strict language plpgsql as
+$$ begin if $1 % 2 = 1 then return true; end if; return null; end $$;
+update qual_fastpath set v = 2 where id = 4;
+select id from qual_fastpath where qual_fastpath_odd(v) order by id;
+
+drop function qual_fastpath_odd(int4);
+drop table qual_fastpath;
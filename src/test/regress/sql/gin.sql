@@ -23,6 +23,15 @@ select gin_clean_pending_list('gin_test_idx'); -- nothing to flush
 delete from gin_test_tbl where i @> array[2];
 vacuum gin_test_tbl;
 
+-- Test the autocleanup storage parameter
+alter index gin_test_idx set (autocleanup = on);
+select reloptions from pg_class where relname = 'gin_test_idx';
+alter index gin_test_idx set (autocleanup = maybe);
+alter index gin_test_idx reset (autocleanup);
+select reloptions from pg_class where relname = 'gin_test_idx';
+create index gin_test_btree_idx on gin_test_tbl using btree (i)
+  with (autocleanup = on);
+
 -- Disable fastupdate, and do more insertions. With fastupdate enabled, most
 -- insertions (by flushing the list pages) cause page splits. Without
 -- fastupdate, we get more churn in the GIN data leaf pages, and exercise the
@@ -430,3 +430,22 @@ select age(timestamp '-infinity', timestamp '-infinity');
 -- test timestamp near POSTGRES_EPOCH_JDATE
 select timestamp '1999-12-31 24:00:00';
 select make_timestamp(1999, 12, 31, 24, 0, 0);
+
+-- Plain ISO 8601 input takes a fast path, which must agree with the general
+-- code; a trailing space sends the same value through the latter.
+set datestyle to iso;
+select v, v::timestamp as ts, v::timestamp = (v || ' ')::timestamp as same
+  from (values ('2024-01-02 03:04:05'), ('2024-01-02T03:04:05'),
+               ('2024-01-02 03:04:05.123456'), ('2024-01-02 03:04:05.12345678'),
+               ('2024-01-02 24:00:00'), ('2024-01-02 03:04:60'),
+               ('2024-02-29 12:00:00'), ('2024-01-02 03:04:05 '),
+               ('2024-01-02')) as t(v);
+select '2024-01-02 03:04:05.987654'::timestamp(2),
+       '2024-12-31 23:59:59.999'::timestamp(0);
+select v, (pg_input_error_info(v, 'timestamp')).message
+  from (values ('2023-02-29 12:00:00'), ('2024-13-01 00:00:00'),
+               ('2024-01-02 25:00:00'), ('2024-01-02 03:60:00')) as t(v);
+select v, v::date as d
+  from (values ('2024-02-29'), ('2024-01-02 '), ('2024-01-02T03:04:05')) as t(v);
+select * from pg_input_error_info('2023-02-29', 'date');
+reset datestyle;
@@ -305,3 +305,55 @@ EXPLAIN (COSTS OFF) :qry;
 :qry;
 
 COMMIT;
+
+----
+-- Check in-memory sorts large enough to use radix sort
+----
+
+-- i4 is a permutation of -500 .. 499; the other keys sort the same way, and
+-- t has ten-way ties that abbreviated keys can't break.  All keys are NULL
+-- in ten more rows.
+CREATE TEMP TABLE radix_sort (i4 int4, i8 int8, ts timestamp, t text COLLATE "C");
+INSERT INTO radix_sort
+    SELECT v, v * 10000000000, '2000-01-01'::timestamp + v * interval '1 hour',
+        'radix' || to_char((v + 500) / 10, 'FM0000')
+    FROM (SELECT (g * 7919) % 1000 - 500 FROM generate_series(1, 1000) g) s(v);
+INSERT INTO radix_sort SELECT NULL FROM generate_series(1, 10);
+
+-- int4, ascending, NULLS LAST
+SELECT count(*) AS misplaced FROM
+    (SELECT i4, row_number() OVER (ORDER BY i4) AS rn FROM radix_sort) s
+    WHERE rn <> coalesce(i4 + 501, rn) OR (i4 IS NULL) <> (rn > 1000);
+
+-- int4, descending, NULLS FIRST
+SELECT count(*) AS misplaced FROM
+    (SELECT i4, row_number() OVER (ORDER BY i4 DESC) AS rn FROM radix_sort) s
+    WHERE rn <> coalesce(510 - i4, rn) OR (i4 IS NULL) <> (rn <= 10);
+
+-- int8, ascending, NULLS FIRST
+SELECT count(*) AS misplaced FROM
+    (SELECT i4, row_number() OVER (ORDER BY i8 NULLS FIRST) AS rn FROM radix_sort) s
+    WHERE rn <> coalesce(i4 + 511, rn) OR (i4 IS NULL) <> (rn <= 10);
+
+-- timestamp, descending, NULLS LAST
+SELECT count(*) AS misplaced FROM
+    (SELECT i4, row_number() OVER (ORDER BY ts DESC NULLS LAST) AS rn FROM radix_sort) s
+    WHERE rn <> coalesce(500 - i4, rn) OR (i4 IS NULL) <> (rn > 1000);
+
+-- abbreviated text, with ties broken by a later key
+SELECT count(*) AS misplaced FROM
+    (SELECT i4, row_number() OVER (ORDER BY t, i4 DESC) AS rn FROM radix_sort) s
+    WHERE rn <> coalesce((i4 + 500) / 10 * 10 + 10 - (i4 + 500) % 10, rn) OR
+        (i4 IS NULL) <> (rn > 1000);
+SELECT count(*) AS misplaced FROM
+    (SELECT i4, row_number() OVER (ORDER BY t DESC, i4) AS rn FROM radix_sort) s
+    WHERE rn <> coalesce((99 - (i4 + 500) / 10) * 10 + 11 + (i4 + 500) % 10, rn) OR
+        (i4 IS NULL) <> (rn <= 10);
+
+-- datum sort
+SELECT array_agg(i4 ORDER BY i4 DESC NULLS LAST) =
+    array(SELECT generate_series(499, -500, -1)) || array_fill(NULL::int4, ARRAY[10])
+    AS sorted
+FROM radix_sort;
+
+DROP TABLE radix_sort;